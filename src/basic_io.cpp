@@ -68,6 +68,17 @@ public:
             std::cout << inst.G[i].get_real_index() << " ";
         std::cout << std::endl;
     }
+    void process_batch(DominationInstance& inst, unidom::SolutionBatch& batch){
+        //Only flush the output once per batch
+        for(int i = 0; i < batch.size(); i++){
+            total_solutions++;
+            std::cout << batch[i].get_size() << " ";
+            for(VertIndex v: batch[i])
+                std::cout << inst.G[v].get_real_index() << " ";
+            std::cout << '\n';
+        }
+        std::cout.flush();
+    }
     void finalize(DominationInstance& inst){
         std::cout << -1 << std::endl;
         unidom::log << "Total Solutions Generated: " << total_solutions << std::endl;
@@ -109,6 +120,14 @@ public:
     void process_set(DominationInstance& inst, VertexSet& dominating_set){
         best_set = dominating_set;
     }
+    void process_batch(DominationInstance& inst, unidom::SolutionBatch& batch){
+        //Only the last set in the batch needs to be copied
+        if (batch.empty())
+            return;
+        best_set.reset_empty();
+        for(VertIndex v: batch[batch.size()-1])
+            best_set.add(v);
+    }
     void finalize(DominationInstance& inst){
         if (print_graph){
             //std::cout << inst.G << std::endl;
@@ -0,0 +1,181 @@
+/*  bbt_activity.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_ACTIVITY_H
+#define BBT_ACTIVITY_H
+
+#include <array>
+#include "unidom_common.hpp"
+#include "unidom_arrayutil.hpp"
+
+//Decaying activity scores for the adaptive vertex choice of the DD and MDD solvers
+//(-activity), in the style of the VSIDS heuristic of SAT solvers. Vertices involved in
+//failures of the search are bumped by an increment which grows after every failure
+//(equivalent to decaying all of the older scores), and the vertices are kept in a
+//binary max-heap of activities, so the most active vertex is found in O(log n).
+//
+//Vertices which are not eligible (e.g. already dominated) are taken out of the heap
+//when they reach the top, and put back by restore when the search node that removed
+//them returns (use ActivityScope), so each choice only pays for the vertices it skips.
+class VertexActivity{
+public:
+    VertexActivity(): n(0), heap_size(0), num_removed(0) {}
+
+    void reset(int num_verts, double decay_factor){
+        n = num_verts;
+        this->decay_factor = decay_factor;
+        increment = 1;
+        heap_size = n;
+        num_removed = 0;
+        for(VertIndex v = 0; v < n; v++){
+            activity[v] = 0;
+            heap[v] = v;
+            position[v] = v;
+        }
+    }
+
+    void bump(VertIndex v){
+        activity[v] += increment;
+        if (activity[v] > RESCALE_LIMIT)
+            rescale();
+        if (position[v] != NOT_IN_HEAP)
+            sift_up(position[v]);
+    }
+    //Called after each failure, so that later bumps count for more
+    void decay(){
+        increment /= decay_factor;
+        if (increment > RESCALE_LIMIT)
+            rescale();
+    }
+
+    //The eligible vertex with the highest activity, with ties broken by better(a,b) (true
+    //if a should be preferred to b). Returns Graph::INVALID_VERTEX if no eligible vertex
+    //has any activity yet (so the caller's usual rule applies).
+    template<typename EligibleFunction, typename BetterFunction>
+    VertIndex choose(EligibleFunction eligible, BetterFunction better){
+        while(heap_size > 0 && !eligible(heap[0]))
+            removed[num_removed++] = pop_top();
+        if (heap_size == 0 || activity[heap[0]] == 0)
+            return Graph::INVALID_VERTEX;
+        double top_activity = activity[heap[0]];
+        VertIndex best = Graph::INVALID_VERTEX;
+        int num_tied = 0;
+        while(heap_size > 0 && activity[heap[0]] == top_activity){
+            VertIndex v = pop_top();
+            if (!eligible(v)){
+                removed[num_removed++] = v;
+                continue;
+            }
+            tied[num_tied++] = v;
+            if (best == Graph::INVALID_VERTEX || better(v,best))
+                best = v;
+        }
+        for(VertIndex v: unidom::array_range(tied,num_tied))
+            insert(v);
+        return best;
+    }
+
+    int removed_mark(){
+        return num_removed;
+    }
+    //Put back the vertices removed by choose since removed_mark returned mark
+    void restore(int mark){
+        while(num_removed > mark)
+            insert(removed[--num_removed]);
+    }
+
+private:
+    static constexpr double RESCALE_LIMIT = 1e100;
+    static const int NOT_IN_HEAP = -1;
+
+    int n;
+    double decay_factor;
+    double increment;
+    std::array<double, unidom::MAX_VERTS> activity;
+
+    std::array<VertIndex, unidom::MAX_VERTS> heap;
+    std::array<int, unidom::MAX_VERTS> position; //Index of each vertex in heap (or NOT_IN_HEAP)
+    int heap_size;
+
+    std::array<VertIndex, unidom::MAX_VERTS> removed;
+    int num_removed;
+    std::array<VertIndex, unidom::MAX_VERTS> tied;
+
+    void rescale(){
+        for(VertIndex v = 0; v < n; v++)
+            activity[v] /= RESCALE_LIMIT;
+        increment /= RESCALE_LIMIT;
+    }
+
+    void insert(VertIndex v){
+        heap[heap_size] = v;
+        position[v] = heap_size;
+        sift_up(heap_size++);
+    }
+    VertIndex pop_top(){
+        VertIndex top = heap[0];
+        position[top] = NOT_IN_HEAP;
+        heap_size--;
+        if (heap_size > 0){
+            heap[0] = heap[heap_size];
+            position[heap[0]] = 0;
+            sift_down(0);
+        }
+        return top;
+    }
+    void sift_up(int i){
+        VertIndex v = heap[i];
+        while(i > 0 && activity[heap[(i-1)/2]] < activity[v]){
+            heap[i] = heap[(i-1)/2];
+            position[heap[i]] = i;
+            i = (i-1)/2;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+    void sift_down(int i){
+        VertIndex v = heap[i];
+        while(2*i+1 < heap_size){
+            int child = 2*i+1;
+            if (child+1 < heap_size && activity[heap[child+1]] > activity[heap[child]])
+                child++;
+            if (activity[heap[child]] <= activity[v])
+                break;
+            heap[i] = heap[child];
+            position[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = v;
+        position[v] = i;
+    }
+};
+
+//Restores the vertices removed from the heap during a search node when it returns
+class ActivityScope{
+public:
+    ActivityScope(VertexActivity& activity): activity(activity), mark(activity.removed_mark()) {}
+    ~ActivityScope(){
+        activity.restore(mark);
+    }
+private:
+    VertexActivity& activity;
+    int mark;
+};
+
+#endif
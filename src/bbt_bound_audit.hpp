@@ -0,0 +1,209 @@
+/*  bbt_bound_audit.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_BOUND_AUDIT_H
+#define BBT_BOUND_AUDIT_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <array>
+#include <random>
+#include "unidom_common.hpp"
+#include "unidom_alloc_tracking.hpp"
+#include "compound_solver.hpp"
+
+//Measures how tight the lower bound of the DD and MDD solvers is (-audit <file>).
+//A random fraction (-audit_rate) of the search nodes is sampled, and for each one the
+//residual problem (the graph with the current set forced in and every other fixed
+//vertex forced out) is solved exactly by a separate solver instance (-audit_solver,
+//MDD by default). One line is appended to the file for each sampled node when it
+//returns, with its depth, the bound on the number of vertices still needed, the true
+//number (the residual optimum minus the depth) and the number of search nodes in its
+//subtree (including itself), so nested samples appear in post-order.
+//
+//The sampling uses its own random generator (seeded with -audit_seed) and the residual
+//is solved on a copy of the instance, so the search itself visits the same nodes as
+//without the audit. -audit_node_limit caps each residual search; if a residual search
+//does not run to completion, its true value is written as "-" (and as "none" if it
+//completed without finding any set).
+class BoundAudit{
+public:
+    BoundAudit(): rate(DEFAULT_RATE), solver_name("MDD"), node_limit(0), seed(1), active(false) {}
+
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-audit")
+            file_name = parser.get_next_string();
+        else if (arg == "-audit_rate"){
+            rate = parser.get_next_double();
+            if (!(rate > 0 && rate <= 1))
+                throw unidom::ConfigurableError("Parameter -audit_rate must be greater than 0 and at most 1.");
+        }else if (arg == "-audit_solver"){
+            solver_name = parser.get_next_string();
+            unidom::SolverPtr solver = unidom::spawn_solver(solver_name);
+            if (!solver)
+                throw unidom::ConfigurableError("Audit solver \""+solver_name+"\" not found.");
+            if (solver->generates_all())
+                throw unidom::ConfigurableError("The audit solver must be an optimizing solver (not "+solver_name+").");
+        }else if (arg == "-audit_node_limit")
+            node_limit = parser.get_next_unsigned_int();
+        else if (arg == "-audit_seed")
+            seed = parser.get_next_unsigned_int();
+        else
+            return false;
+        return true;
+    }
+
+    //Called before the search of each instance
+    void start(std::string main_solver_name, int n){
+        active = false;
+        if (file_name == "")
+            return;
+        if (file_name != "-"){
+            file_stream.open(file_name, std::ios_base::app);
+            if (!file_stream){
+                unidom::log << "Unable to open audit file \"" << file_name << "\"" << std::endl;
+                return;
+            }
+        }
+        active = true;
+        random_generator.seed(seed);
+        num_sampled = 0;
+        out() << "# " << main_solver_name << " on " << n << " vertices (audit rate " << rate << ", audit solver " << solver_name << ")" << std::endl;
+        out() << "# depth bound optimum subtree_nodes" << std::endl;
+    }
+    //Called after the search
+    void finish(){
+        if (!active)
+            return;
+        unidom::log << "Bound audit: " << num_sampled << " nodes sampled" << std::endl;
+        if (file_stream.is_open())
+            file_stream.close();
+        active = false;
+    }
+
+    //Created at the start of each search node (after the resmod check). If the node is
+    //sampled, the caller passes it the residual state with measure(), and the line for
+    //the node is written when the scope ends (so the subtree size is known).
+    class Scope{
+    public:
+        Scope(BoundAudit& audit, const unsigned long long& nodes_visited):
+            audit(audit), nodes_visited(nodes_visited), first_node(nodes_visited), measured(false) {}
+        ~Scope(){
+            if (measured)
+                audit.write(depth, bound, optimum, nodes_visited - first_node + 1);
+        }
+        bool sample(){
+            return audit.active && audit.unit_interval(audit.random_generator) < audit.rate;
+        }
+        //bound is the lower bound on the number of vertices which must still be added to D
+        //(unidom::MAX_VERTS or more if the residual has no solution). fixed[v] is nonzero
+        //for each vertex which cannot be added (including the vertices of D).
+        template<typename FixedArray>
+        void measure(unidom::DominationInstance& inst, VertexSet& D, const FixedArray& fixed, unsigned int bound){
+            measured = true;
+            depth = D.get_size();
+            this->bound = bound;
+            optimum = audit.solve_residual(inst, D, fixed);
+        }
+    private:
+        BoundAudit& audit;
+        const unsigned long long& nodes_visited;
+        unsigned long long first_node;
+        bool measured;
+        unsigned int depth, bound;
+        int optimum;
+    };
+
+private:
+    static constexpr double DEFAULT_RATE = 0.001;
+    static const int UNKNOWN = -1;
+    static const int NO_SOLUTION = -2;
+
+    std::string file_name; //Empty if the audit is disabled ("-" for the log stream)
+    double rate;
+    std::string solver_name;
+    unsigned int node_limit; //0 for no limit
+    unsigned int seed;
+
+    bool active;
+    std::ofstream file_stream;
+    std::mt19937_64 random_generator;
+    std::uniform_real_distribution<double> unit_interval;
+    unsigned long long num_sampled;
+
+    std::ostream& out(){
+        return file_stream.is_open()? (std::ostream&)file_stream : unidom::log;
+    }
+
+    //The number of vertices which must be added to D in the residual problem (or
+    //UNKNOWN or NO_SOLUTION). The solvers add loops to their graph, so the residual
+    //graph is copied without them.
+    template<typename FixedArray>
+    int solve_residual(unidom::DominationInstance& inst, VertexSet& D, const FixedArray& fixed){
+        unidom::IgnoredAllocationScope ignore_allocations; //Not part of the search being audited
+        Graph& G = inst.G;
+        int n = G.n();
+        unidom::DominationInstance residual;
+        residual.G.reset(n);
+        for(VertIndex v = 0; v < n; v++)
+            for(VertIndex u: G[v].neighbours())
+                if (u != v)
+                    residual.G[v].neighbours().push_back(u);
+        residual.force_in = D;
+        for(VertIndex v = 0; v < n; v++)
+            if (fixed[v] && !D.contains(v))
+                residual.force_out.add(v);
+
+        unidom::SolverPtr solver = unidom::spawn_solver(solver_name);
+        std::vector<std::string> arguments;
+        if (node_limit > 0)
+            arguments = {"-node_limit", std::to_string(node_limit)};
+        unidom::ListArgumentTokenizer tokenizer(arguments);
+        if (!solver->parse_arguments(tokenizer))
+            throw unidom::ConfigurableError("Invalid arguments for audit solver \""+solver_name+"\".");
+        BestSetCaptureProxy capture;
+        solver->solve(residual, capture);
+        num_sampled++;
+        if (!solver->result_is_optimal())
+            return UNKNOWN;
+        if (!capture.found)
+            return NO_SOLUTION;
+        return capture.best_set.get_size() - D.get_size();
+    }
+
+    void write(unsigned int depth, unsigned int bound, int optimum, unsigned long long subtree_nodes){
+        unidom::IgnoredAllocationScope ignore_allocations;
+        std::ostream& o = out();
+        o << depth << " ";
+        if (bound >= (unsigned int)unidom::MAX_VERTS)
+            o << "none";
+        else
+            o << bound;
+        if (optimum == UNKNOWN)
+            o << " -";
+        else if (optimum == NO_SOLUTION)
+            o << " none";
+        else
+            o << " " << optimum;
+        o << " " << subtree_nodes << std::endl;
+    }
+};
+
+#endif
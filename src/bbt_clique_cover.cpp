@@ -0,0 +1,49 @@
+/*  bbt_clique_cover.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include "unidom_common.hpp"
+#include "bbt_line_cover.hpp"
+
+using std::string;
+
+using unidom::Solver;
+using unidom::DominationInstance;
+
+
+//The CC solvers run the line cover search (see bbt_line_cover.hpp) on the edge
+//clique cover of the instance, or on a greedy cover if the instance has none.
+//The board generators supply a cover made of the lines of the board.
+struct CliqueCoverLines: public LineCoverPolicy{
+    bool build(DominationInstance& inst, CliqueCover& lines){
+        lines = instance_clique_cover(inst);
+        return true;
+    }
+    static string requirement(){
+        return "a graph with an edge clique cover";
+    }
+};
+
+
+namespace{
+    typedef LineCoverSolver<CliqueCoverLines,false> CliqueCoverSolver;
+    typedef LineCoverSolver<CliqueCoverLines,true> CliqueCoverSolver_all;
+}
+REGISTER_SOLVER( CliqueCoverSolver, "CC", "DD Bounding Solver using an edge clique cover of the graph (optimization)");
+REGISTER_SOLVER( CliqueCoverSolver_all, "CC_all", "DD Bounding Solver using an edge clique cover of the graph (generation)");
@@ -0,0 +1,387 @@
+/*  bbt_dd_bitset.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+#include "unidom_common.hpp"
+#include "unidom_arrayutil.hpp"
+#include "bbt_framework.hpp"
+#include "bbt_degreepq.hpp"
+#include "graph_util.hpp"
+
+using std::string;
+using std::array;
+using std::min;
+using std::max;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+using unidom::MAX_VERTS;
+using unidom::array_range;
+using unidom::iterate_reverse;
+
+
+
+namespace{
+    const int RANK_NEIGHBOURS_ASCENDING = 0;
+    const int RANK_NEIGHBOURS_DESCENDING = 1;
+
+    typedef std::uint64_t BitWord;
+    const int BITSET_WORDS = (MAX_VERTS+63)/64;
+    typedef array<BitWord, BITSET_WORDS> BitRow;
+
+    //Number of set bits of (row & mask) in words [first,last]
+    __attribute__((target_clones("popcnt","default")))
+    int masked_popcount(const BitRow& row, const BitRow& mask, int first, int last){
+        int count = 0;
+        for(int w = first; w <= last; w++)
+            count += __builtin_popcountll(row[w] & mask[w]);
+        return count;
+    }
+}
+
+//The DD solver (with the minCD vertex choice) without incremental domination degrees.
+//The closed neighbourhood of each vertex, the undominated vertices and the candidate
+//vertices are kept as bitsets, and the domination degree of a vertex is counted
+//(with popcounts) only when the bound or the neighbour ranking needs it. Adding a
+//vertex to the set just clears the bits of newly dominated vertices, instead of
+//updating the degree of every vertex within distance two. The candidate degrees
+//(which determine the vertex to branch on, including ties) are still kept in a
+//DegreePQHeavy, so the search tree and the output are identical to DD_minCD_asc or
+//DD_minCD_desc. This is usually faster on small dense graphs, where each dominated
+//vertex changes many degrees.
+template<unsigned int RANK_NEIGHBOURS_RULE, bool GENERATE_ALL>
+class BBTDDBitsetSolver: public BBTFrameworkSolver{
+    static_assert( RANK_NEIGHBOURS_RULE <= RANK_NEIGHBOURS_DESCENDING, "RANK_NEIGHBOURS_RULE must be either RANK_NEIGHBOURS_ASCENDING or RANK_NEIGHBOURS_DESCENDING" );
+public:
+    bool generates_all(){
+        return GENERATE_ALL;
+    }
+
+    void solve(DominationInstance& inst, unidom::OutputProxy& output_proxy){
+        dom_inst = &inst;
+        Graph& G = inst.G;
+        this->output_proxy = &output_proxy;
+
+        add_loops(G);
+        sort_neighbours_descending(G);
+
+        int n = inst.G.n();
+        D.reset();
+        B.reset_full(n-1);
+
+        if (!GENERATE_ALL && total_upper_bound < n)
+            B.reset_full(total_upper_bound+1);
+
+        covered.fill(0);
+        fixed.fill(0);
+
+        total_covered = 0;
+        total_fixed = 0;
+
+        //Closed neighbourhood rows (with the range of words containing any bits)
+        num_words = (n+63)/64;
+        for(VertIndex v = 0; v < n; v++){
+            neighbourhood_rows[v].fill(0);
+            for(VertIndex u: G[v].neighbours())
+                neighbourhood_rows[v][u/64] |= BitWord(1) << (u%64);
+            row_first_word[v] = num_words-1;
+            row_last_word[v] = 0;
+            for(int w = 0; w < num_words; w++)
+                if (neighbourhood_rows[v][w]){
+                    row_first_word[v] = min(row_first_word[v],w);
+                    row_last_word[v] = max(row_last_word[v],w);
+                }
+        }
+        degree_counts.fill(0);
+        undominated_bits.fill(0);
+        candidate_bits.fill(0);
+        for(VertIndex v = 0; v < n; v++){
+            set_bit(undominated_bits,v);
+            set_bit(candidate_bits,v);
+        }
+
+        DegreePQHeavy C_DPQ(G);
+        CandidateDPQ = &C_DPQ;
+
+        //Add all of the "force_in" vertices to the dominating set
+        for(VertIndex v: inst.force_in){
+            remove_candidate(G,v);
+            D.add(v);
+            for(VertIndex u: G[v].neighbours())
+                dominate(u);
+        }
+
+        //Set all of the "force_out" vertices to be forbidden
+        for(VertIndex v: inst.force_out)
+            remove_candidate(G,v);
+
+        reset_depth_log();
+
+        output_proxy.initialize(inst);
+        prepare_emitted_sets(n);
+        if (!GENERATE_ALL)
+            seed_incumbent(inst,output_proxy,B);
+        run_search(B, D.get_size(), [&]{ FindDominatingSet<true>(G); });
+        flush_emitted_sets(inst,output_proxy);
+        output_proxy.finalize(inst);
+
+        print_depth_log();
+
+        CandidateDPQ = nullptr;
+    }
+
+private:
+    DominationInstance* dom_inst;
+    OutputProxy* output_proxy;
+
+    VertexSet D; //Current working set
+    VertexSet B; //Best set found so far
+
+    DegreePQHeavy* CandidateDPQ; //Tracks the candidate degree of each vertex
+
+    array<int,MAX_VERTS> covered, fixed;
+    int total_covered, total_fixed;
+
+    int num_words;
+    array<BitRow,MAX_VERTS> neighbourhood_rows;
+    array<int,MAX_VERTS> row_first_word, row_last_word;
+    BitRow undominated_bits, candidate_bits;
+
+    //Domination degrees of the candidates, counted by bounds_satisfied (and used by
+    //rank_neighbours at the same search node)
+    array<int,MAX_VERTS> domination_degree;
+    //Number of candidates with each domination degree (all zero between calls)
+    array<int,MAX_VERTS+1> degree_counts;
+
+    static void set_bit(BitRow& row, VertIndex v){
+        row[v/64] |= BitWord(1) << (v%64);
+    }
+    static void clear_bit(BitRow& row, VertIndex v){
+        row[v/64] &= ~(BitWord(1) << (v%64));
+    }
+
+    void sort_neighbours_descending(Graph& G){
+        auto cmp = [&G](const VertIndex &a, const VertIndex &b){
+            //Sort into descending order
+            return a > b;
+        };
+        for(auto& v: G.V()){
+            std::stable_sort(v.neighbours().begin(), v.neighbours().end(),cmp);
+        }
+    }
+
+    void add_loops(Graph& G){
+        for(auto& v: G.V())
+            v.add_neighbour_simple(v.get_index());
+    }
+
+    void add_candidate(Graph& G, VertIndex v){
+        assert(fixed[v]);
+        fixed[v] = 0;
+        total_fixed--;
+        set_bit(candidate_bits,v);
+        CandidateDPQ->add_candidate(v);
+        for(VertIndex u: G[v].neighbours())
+            CandidateDPQ->increment(u);
+    }
+    bool remove_candidate(Graph& G, VertIndex v){ //Returns true if v must be in the dominating set.
+        assert(!fixed[v]);
+        fixed[v] = 1;
+        total_fixed++;
+        clear_bit(candidate_bits,v);
+        CandidateDPQ->remove_candidate(v);
+        bool forced = false;
+        for(VertIndex u: G[v].neighbours())
+            if (CandidateDPQ->decrement(u) == 0 && !covered[u])
+                forced = true;
+        return forced;
+    }
+
+    void dominate(VertIndex v){
+        covered[v]++;
+        if (covered[v] > 1)
+            return;
+        total_covered++;
+        clear_bit(undominated_bits,v);
+        CandidateDPQ->dominate(v);
+    }
+    void undominate(VertIndex v){
+        covered[v]--;
+        if (covered[v] > 0)
+            return;
+        total_covered--;
+        set_bit(undominated_bits,v);
+        CandidateDPQ->undominate(v);
+    }
+
+    template<bool check_resmod_depth>
+    void add_vertex_to_set(Graph& G, VertIndex j, int* fixed_list, int& num_fixed){
+        remove_candidate(G, j);
+        fixed_list[num_fixed++] = j;
+
+        D.add(j);
+        for(VertIndex k: G[j].neighbours())
+            dominate(k);
+
+        FindDominatingSet<check_resmod_depth>(G);
+
+        for(VertIndex k: iterate_reverse(G[j].neighbours()))
+            undominate(k);
+        D.remove_pop(j);
+    }
+
+    //The same bound as DD (the fewest candidates, taken in descending order of domination
+    //degree, which could dominate the remaining vertices), from a histogram of degrees
+    bool bounds_satisfied(Graph& G){
+        int n = G.n();
+
+        int max_degree = 0;
+        for(int w = 0; w < num_words; w++){
+            for(BitWord bits = candidate_bits[w]; bits; bits &= bits-1){
+                VertIndex v = w*64 + __builtin_ctzll(bits);
+                int degree = masked_popcount(neighbourhood_rows[v], undominated_bits, row_first_word[v], row_last_word[v]);
+                domination_degree[v] = degree;
+                max_degree = max(max_degree,degree);
+                degree_counts[degree]++;
+            }
+        }
+
+        int min_vertices_needed = 0;
+        int remaining = n-total_covered;
+        for(int degree = max_degree; remaining > 0; degree--){
+            if (degree == 0){
+                min_vertices_needed = unidom::MAX_VERTS+1; //No set of candidates dominates the remaining vertices
+                break;
+            }
+            int count = degree_counts[degree];
+            int vertices_needed = (remaining+degree-1)/degree;
+            if (vertices_needed <= count){
+                min_vertices_needed += vertices_needed;
+                remaining = 0;
+            }else{
+                min_vertices_needed += count;
+                remaining -= degree*count;
+            }
+        }
+        std::fill(degree_counts.begin(), degree_counts.begin()+max_degree+1, 0);
+
+        int min_total_size = D.get_size() + min_vertices_needed;
+        if(GENERATE_ALL){
+            if (min_total_size > (int)total_upper_bound || n - total_fixed < min_vertices_needed)
+                return false;
+        }else{
+            if (min_total_size >= (int)B.get_size() || n - total_fixed < min_vertices_needed)
+                return false;
+        }
+        return true;
+    }
+
+    //Candidates in N[v] by domination degree (ascending or descending). Ties keep the order
+    //of the DegreePQ-based ranking of DD: neighbour list order when ascending, and the
+    //reverse when descending.
+    void rank_neighbours(Graph& G, VertIndex v, VertIndex* neighbour_array, int& neighbour_count){
+        neighbour_count = 0;
+        if (RANK_NEIGHBOURS_RULE == RANK_NEIGHBOURS_ASCENDING){
+            for(VertIndex u: G[v].neighbours())
+                if (!fixed[u])
+                    neighbour_array[neighbour_count++] = u;
+            unidom::insertion_sort(neighbour_array, neighbour_array+neighbour_count, [this](VertIndex a, VertIndex b){
+                return domination_degree[a] < domination_degree[b];
+            });
+        }else{
+            for(VertIndex u: iterate_reverse(G[v].neighbours()))
+                if (!fixed[u])
+                    neighbour_array[neighbour_count++] = u;
+            unidom::insertion_sort(neighbour_array, neighbour_array+neighbour_count, [this](VertIndex a, VertIndex b){
+                return domination_degree[a] > domination_degree[b];
+            });
+        }
+    }
+
+    template<bool check_resmod_depth>
+    void FindDominatingSet(Graph& G){
+        int depth = D.get_size();
+        int resmod_check = report_node<check_resmod_depth>(depth);
+        if (resmod_check == 0)
+            return;
+        else if (check_resmod_depth && resmod_check == 1){
+            unreport_node(depth);
+            FindDominatingSet<false>(G);
+            return;
+        }
+
+        int n = G.n();
+
+        if (total_covered == n){
+            if (GENERATE_ALL){
+                if (D.get_size() >= total_lower_bound && D.get_size() <= total_upper_bound)
+                    emit_set(*dom_inst,*output_proxy,D);
+            }else{
+                if (D.get_size() >= total_lower_bound && D.get_size() < B.get_size()){
+                    B = D;
+                    emit_set(*dom_inst,*output_proxy,D);
+                    check_lower_bound_hint(B.get_size());
+                }
+            }
+            return;
+        }
+
+        VertIndex i = CandidateDPQ->get_min_undominated_vertex();
+        if (i == Graph::INVALID_VERTEX)
+            return;
+        assert(!covered[i] && i < n && G[i].deg() > 0);
+
+        if (!bounds_satisfied(G))
+            return;
+
+        int i_deg = G[i].deg();
+        VertIndex neighbour_array[i_deg+1];
+        int neighbour_count = 0;
+        rank_neighbours(G,i,neighbour_array,neighbour_count);
+
+        int fixed_list[i_deg+1];
+        int num_fixed = 0;
+        for(VertIndex j: array_range(neighbour_array,neighbour_count))
+            add_vertex_to_set<check_resmod_depth>(G,j,fixed_list,num_fixed);
+
+        //Unfixed in the order they were fixed (as in DD)
+        for(int q = 0; q < num_fixed; q++)
+            add_candidate(G, fixed_list[q]);
+    }
+
+};
+
+namespace{
+    typedef BBTDDBitsetSolver<RANK_NEIGHBOURS_ASCENDING,false> DD_bits_asc;
+    typedef BBTDDBitsetSolver<RANK_NEIGHBOURS_ASCENDING,true> DD_bits_asc_all;
+    typedef BBTDDBitsetSolver<RANK_NEIGHBOURS_DESCENDING,false> DD_bits_desc;
+    typedef BBTDDBitsetSolver<RANK_NEIGHBOURS_DESCENDING,true> DD_bits_desc_all;
+}
+REGISTER_SOLVER( DD_bits_asc, "DD_bits_asc", "DD_minCD_asc with domination degrees counted from neighbourhood bitsets (optimization)");
+REGISTER_SOLVER( DD_bits_asc_all, "DD_bits_asc_all", "DD_minCD_asc with domination degrees counted from neighbourhood bitsets (generation)");
+
+REGISTER_SOLVER( DD_bits_desc, "DD_bits_desc", "DD_minCD_desc with domination degrees counted from neighbourhood bitsets (optimization)");
+REGISTER_SOLVER( DD_bits_desc_all, "DD_bits_desc_all", "DD_minCD_desc with domination degrees counted from neighbourhood bitsets (generation)");
@@ -27,6 +27,10 @@
 #include "unidom_arrayutil.hpp"
 #include "bbt_framework.hpp"
 #include "bbt_degreepq.hpp"
+#include "bbt_activity.hpp"
+#include "bbt_nogoods.hpp"
+#include "bbt_bound_audit.hpp"
+#include "bbt_policy_dispatch.hpp"
 #include "graph_util.hpp"
 
 using std::string;
@@ -57,6 +61,21 @@ class BBTDDSolverVariant: public BBTFrameworkSolver{
     static_assert( CHOOSE_VERTEX_RULE <= CHOOSE_VERTEX_MAX_CD, "CHOOSE_VERTEX_RULE must be either CHOOSE_VERTEX_MIN_CD or CHOOSE_VERTEX_MAX_CD" );
     static_assert( RANK_NEIGHBOURS_RULE <= RANK_NEIGHBOURS_DESCENDING, "RANK_NEIGHBOURS_RULE must be either RANK_NEIGHBOURS_ASCENDING or RANK_NEIGHBOURS_DESCENDING" );
 public:
+    BBTDDSolverVariant(): activity_enabled(false), activity_decay(0.95) {}
+    bool generates_all(){
+        return GENERATE_ALL;
+    }
+    
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-activity")
+            activity_enabled = true;
+        else if (arg == "-activity_decay")
+            activity_decay = parser.get_next_double();
+        else if (!audit.accept_argument(arg,parser) && !analysis.accept_argument(arg,parser))
+            return BBTFrameworkSolver::accept_argument(arg,parser);
+        return true;
+    }
+    
     void solve(DominationInstance& inst, unidom::OutputProxy& output_proxy){
         dom_inst = &inst;
         Graph& G = inst.G;
@@ -94,6 +113,7 @@ public:
             for(VertIndex u: G[v].neighbours()){
                 dominate(G,u);
             }
+            UndominatedDPQ->apply_queued_deltas();
         }
         
         
@@ -104,11 +124,24 @@ public:
         
         
         
+        activity.reset(n, activity_decay);
+        branch_vertex = Graph::INVALID_VERTEX;
         
         reset_depth_log();
         
         output_proxy.initialize(inst);
-        FindDominatingSet<true>(G);
+        prepare_emitted_sets(n);
+        if (!GENERATE_ALL)
+            seed_incumbent(inst,output_proxy,B);
+        audit.start(name(), n);
+        analysis.start(inst);
+        run_search(B, D.get_size(), [&]{
+            analysis.start_search();
+            FindDominatingSet<true>(G);
+        });
+        audit.finish();
+        analysis.finish(verbose);
+        flush_emitted_sets(inst,output_proxy);
         output_proxy.finalize(inst);
         
         print_depth_log();
@@ -128,8 +161,54 @@ private:
     DegreePQLight* UndominatedDPQ; //Tracks the domination degree of each vertex
     DegreePQHeavy* CandidateDPQ; //Tracks the candidate degree of each vertex
     
-    array<int,MAX_VERTS> covered, fixed;
+    array<StoredVertCount,MAX_VERTS> covered, fixed;
     int total_covered, total_fixed;
+    
+    //Adaptive vertex choice (enabled with -activity). A bound failure bumps the vertex
+    //being dominated by the branch that led to it (branch_vertex), and a vertex with no
+    //candidates left is bumped itself. Undominated vertices with at most one candidate
+    //are still chosen first; otherwise the most active undominated vertex is chosen
+    //(with ties broken by the CHOOSE_VERTEX_RULE), and the CHOOSE_VERTEX_RULE alone is
+    //used until some undominated vertex has been bumped.
+    bool activity_enabled;
+    double activity_decay;
+    VertexActivity activity;
+    VertIndex branch_vertex;
+    
+    BoundAudit audit; //Samples the tightness of the bound (with -audit)
+    
+    ConflictAnalysis analysis; //Nogoods and backjumping (with -nogoods)
+    
+    void record_failure(VertIndex v){
+        if (!activity_enabled || v == Graph::INVALID_VERTEX)
+            return;
+        activity.bump(v);
+        activity.decay();
+    }
+    
+    //The bound fails at once if some undominated vertex has no candidates left, and that
+    //vertex alone explains it
+    void explain_bound(Graph& G, ConflictSet& conflict){
+        VertIndex t = CandidateDPQ->get_min_undominated_vertex();
+        if (t != Graph::INVALID_VERTEX && CandidateDPQ->ranked_degree(t) == 0)
+            analysis.explain_trapped_vertex(G, t, conflict);
+        else
+            analysis.explain_bound(G, D, covered, fixed, conflict);
+    }
+    
+    VertIndex choose_active_vertex(VertIndex rule_choice){
+        VertIndex min_cd_vertex = (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_CD)? rule_choice : CandidateDPQ->get_min_undominated_vertex();
+        if (CandidateDPQ->ranked_degree(min_cd_vertex) <= 1)
+            return min_cd_vertex;
+        VertIndex v = activity.choose([this](VertIndex u){ return covered[u] == 0; }, [this](VertIndex a, VertIndex b){
+            if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_CD)
+                return CandidateDPQ->ranked_degree(a) < CandidateDPQ->ranked_degree(b);
+            else
+                return CandidateDPQ->ranked_degree(a) > CandidateDPQ->ranked_degree(b);
+        });
+        return (v == Graph::INVALID_VERTEX)? rule_choice : v;
+    }
+    
         
     void sort_neighbours_descending(Graph& G){
         auto cmp = [&G](const VertIndex &a, const VertIndex &b){
@@ -190,7 +269,7 @@ private:
         UndominatedDPQ->dominate(v);
         CandidateDPQ->dominate(v);
         for(VertIndex u: G[v].neighbours())
-            UndominatedDPQ->decrement(u);
+            UndominatedDPQ->queue_delta(u,-1);
     }
     void undominate(Graph& G, VertIndex v){
         covered[v]--;
@@ -201,7 +280,7 @@ private:
         UndominatedDPQ->undominate(v);
         CandidateDPQ->undominate(v);
         for(VertIndex u: G[v].neighbours()) //Congruent to original, but should be reversed
-            UndominatedDPQ->increment(u);
+            UndominatedDPQ->queue_delta(u,1);
             
     }
     
@@ -216,11 +295,14 @@ private:
         for(VertIndex k: G[j].neighbours()){
             dominate(G, k);
         }
-        FindDominatingSet<check_resmod_depth>(G);
+        UndominatedDPQ->apply_queued_deltas();
+        if (!analysis.is_enabled() || !analysis.prune(NogoodDatabase::in_literal(j), D, fixed, analysis.conflict(D.get_size())))
+            FindDominatingSet<check_resmod_depth>(G);
         
         for(VertIndex k: iterate_reverse(G[j].neighbours())){
             undominate(G, k);
         }
+        UndominatedDPQ->apply_queued_deltas();
                 
         D.remove_pop(j);
         return forced;
@@ -317,8 +399,11 @@ private:
     template<bool check_resmod_depth>
     void FindDominatingSet(Graph& G){
         int resmod_check = report_node<check_resmod_depth>(D.get_size());
-        if (resmod_check == 0)
+        if (resmod_check == 0){
+            if (analysis.is_enabled())
+                analysis.conflict(D.get_size()).set_all();
             return;
+        }
         else if (check_resmod_depth && resmod_check == 1){
             unreport_node(D.get_size());
             FindDominatingSet<false>(G);
@@ -330,54 +415,100 @@ private:
         if (total_covered == n){
             if (GENERATE_ALL){
                 if (D.get_size() >= total_lower_bound && D.get_size() <= total_upper_bound)
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
             }else{
                 if (D.get_size() >= total_lower_bound && D.get_size() < B.get_size()){
                     B = D;
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
+                    check_lower_bound_hint(B.get_size());
                 }
             }
+            if (analysis.is_enabled()){
+                //Unless its supersets could still be output, no set containing D is better
+                bool supersets_wanted = GENERATE_ALL? D.get_size() <= total_upper_bound : D.get_size() < total_lower_bound;
+                analysis.explain_complete_set(D, supersets_wanted, analysis.conflict(D.get_size()));
+            }
             return;
         }
         
+        BoundAudit::Scope audit_scope(audit, nodes_visited);
+        if (audit_scope.sample())
+            audit_scope.measure(*dom_inst, D, fixed, UndominatedDPQ->count_minimum_to_dominate(n-total_covered));
+        
         VertIndex i = Graph::INVALID_VERTEX;
         if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_CD){
             i = CandidateDPQ->get_min_undominated_vertex();
         } else if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MAX_CD){
             i = CandidateDPQ->get_max_undominated_vertex();
         }
-        if (i == Graph::INVALID_VERTEX)
+        if (i == Graph::INVALID_VERTEX){
+            if (analysis.is_enabled())
+                analysis.conflict(D.get_size()).set_all();
             return;
+        }
+        ActivityScope activity_scope(activity);
+        if (activity_enabled)
+            i = choose_active_vertex(i);
         //TODO remove
         assert(!covered[i] && i < n && G[i].deg() > 0);
         
         int i_deg = G[i].deg();
         
         if (!RECHECK_BOUNDS_IN_LOOP){
-            if (!bounds_satisfied(G))
+            if (!bounds_satisfied(G)){
+                record_failure(branch_vertex);
+                if (analysis.is_enabled())
+                    explain_bound(G, analysis.conflict(D.get_size()));
                 return;
+            }
         }
         
         VertIndex neighbour_array[i_deg+1];
         int neighbour_count = 0;
         rank_neighbours(G,i,neighbour_array,neighbour_count);
+        if (neighbour_count == 0)
+            record_failure(i);
+        VertIndex parent_branch_vertex = branch_vertex;
+        branch_vertex = i;
     
         
         int fixed_list[i_deg+1]; //Standard C, but not standard C++
         int num_fixed = 0;
         
+        //The explanation of each branch is left one level down
+        int depth = D.get_size();
+        ConflictSet* node_conflict = analysis.is_enabled()? &analysis.conflict(depth) : nullptr;
+        ConflictSet* branch_conflict = analysis.is_enabled()? &analysis.conflict(depth+1) : nullptr;
+        if (analysis.is_enabled())
+            node_conflict->clear();
+        bool explained_by_branch = false;
+        
         bool end_branch = false;
         for(VertIndex j: array_range(neighbour_array,neighbour_count)){
             if (RECHECK_BOUNDS_IN_LOOP && !bounds_satisfied(G)){
+                record_failure(branch_vertex);
+                if (analysis.is_enabled()){
+                    //The bound also holds in each of the remaining branches
+                    explain_bound(G, *branch_conflict);
+                    explained_by_branch = analysis.absorb(*node_conflict, *branch_conflict, fixed_list, num_fixed);
+                }
                 end_branch = true;
                 break;
             }
             bool force_stop = add_vertex_to_set<check_resmod_depth>(G,j,fixed_list,num_fixed);
+            if (analysis.is_enabled() && analysis.branch_failed(D, fixed, *node_conflict, *branch_conflict, fixed_list, num_fixed, neighbour_count, explained_by_branch))
+                break;
             if (FORCE_STOP_ON_TRAPPED_VERTEX && force_stop){
+                if (analysis.is_enabled()){
+                    analysis.explain_forced_stop(G, j, [this](VertIndex u){ return !covered[u] && CandidateDPQ->ranked_degree(u) == 0; }, *branch_conflict);
+                    explained_by_branch = analysis.absorb(*node_conflict, *branch_conflict, fixed_list, num_fixed);
+                }
                 end_branch = true;
                 break;
             }	
         }
+        if (analysis.is_enabled())
+            analysis.finish_node(G, i, fixed, *node_conflict, fixed_list, num_fixed, explained_by_branch);
         
         /*
         for(int q = num_fixed - 1; q >= 0; q--){
@@ -385,6 +516,8 @@ private:
         }
         */
         
+        branch_vertex = parent_branch_vertex;
+        
         //Duplicating an odd quirk of original implementation, we don't unstack fixed vertices
         //(so they're unstacked in the same order they were stacked)
         for(int q = 0; q < num_fixed; q++){
@@ -416,6 +549,18 @@ REGISTER_SOLVER( DD_minCD_desc, "DD_minCD_desc", "DD_minCD_desc");
 REGISTER_SOLVER( DD_minCD_desc_all, "DD_minCD_desc_all", "DD_minCD_desc_all");
 
 
-REGISTER_SOLVER_ALIAS( DD_minCD_asc, DD_basic, "DD", "DD Bounding Solver (optimization)");
-REGISTER_SOLVER_ALIAS( DD_minCD_asc_all, DD_basic_all, "DD_all", "DD Bounding Solver (generation)");
+namespace{
+    //DD with its policy chosen at runtime (the default is DD_minCD_asc)
+    template<bool GENERATE_ALL>
+    class DDPolicySolver: public PolicyDispatchSolver{
+    public:
+        DDPolicySolver(): PolicyDispatchSolver( {"minCD","maxCD"},
+            PolicyTable<BBTDDSolverVariant,GENERATE_ALL,2>::constructors.data(),
+            {CHOOSE_VERTEX_MIN_CD,RANK_NEIGHBOURS_ASCENDING,false,false} ) {}
+    };
+    typedef DDPolicySolver<false> DD_policy;
+    typedef DDPolicySolver<true> DD_policy_all;
+}
+REGISTER_SOLVER( DD_policy, "DD", "DD Bounding Solver (optimization). Policies: -choose minCD/maxCD, -rank asc/desc, -force_stop, -recheck");
+REGISTER_SOLVER( DD_policy_all, "DD_all", "DD Bounding Solver (generation). Policies: -choose minCD/maxCD, -rank asc/desc, -force_stop, -recheck");
 
@@ -82,7 +82,7 @@ public:
         PQNode* old_node = vertex_node.degree_node;
         int old_deg = old_node->deg;
         int new_deg = old_deg+1;
-        assert( old_deg >= 0 && old_deg < n-2 );
+        assert( old_deg >= 0 && old_deg < n );
         
         
         PQNode* new_node = &nodes[new_deg];
@@ -126,7 +126,7 @@ public:
         PQNode* old_node = vertex_node.degree_node;
         int old_deg = old_node->deg;
         int new_deg = old_deg-1;
-        assert( old_deg >= 1 && old_deg < n-1 );
+        assert( old_deg >= 1 && old_deg <= n );
         
         PQNode* new_node = &nodes[new_deg];
         
@@ -163,8 +163,84 @@ public:
         return new_deg;
     }
     
+    //Move v directly from its current degree to degree+delta, with the same result as
+    //|delta| calls to increment or decrement (but only one move between degree lists).
+    int apply_delta(VertIndex v, int delta){
+        PQVertex& vertex_node = vertices[v];
+        PQNode* old_node = vertex_node.degree_node;
+        int old_deg = old_node->deg;
+        int new_deg = old_deg+delta;
+        if (delta == 0)
+            return old_deg;
+        assert( new_deg >= 0 && new_deg <= n );
+        
+        PQNode* new_node = &nodes[new_deg];
+        
+        if (new_node->count == 0){
+            //Find the nonempty degrees on either side of new_deg, starting from old_deg
+            PQNode *before, *after;
+            if (delta > 0){
+                before = old_node;
+                while(before->next != &head_tail && before->next->deg < new_deg)
+                    before = before->next;
+                after = before->next;
+            }else{
+                after = old_node;
+                while(after->prev != &head_tail && after->prev->deg > new_deg)
+                    after = after->prev;
+                before = after->prev;
+            }
+            new_node->prev = before;
+            new_node->next = after;
+            before->next = after->prev = new_node;
+        }
+        vertex_node.degree_node = new_node;
+        new_node->count++;
+        
+        if (is_heavy){
+            if (!vertex_node.is_dominated){
+                splice_out(vertex_node);
+                splice_in(vertex_node);
+                old_node->undominated_count--;
+                new_node->undominated_count++;
+            }
+        }
+        
+        bool is_unfixed = !vertex_node.is_fixed;
+        old_node->unfixed_count -= is_unfixed;
+        new_node->unfixed_count += is_unfixed;
+        
+        old_node->count--;
+        if (old_node->count == 0){
+            old_node->prev->next = old_node->next;
+            old_node->next->prev = old_node->prev;
+            old_node->next = old_node->prev = nullptr;
+        }
+        return new_deg;
+    }
     
-    
+    //Batched updates: queue_delta records a change to the degree of v without applying
+    //it, and apply_queued_deltas then moves each queued vertex once (with apply_delta),
+    //instead of one degree at a time. Degrees are out of date until the queue is applied.
+    //(In a heavy DegreePQ, the order of the undominated lists may differ from applying
+    //the same changes one at a time.)
+    void queue_delta(VertIndex v, int delta){
+        PQVertex& vertex_node = vertices[v];
+        if (!vertex_node.queued){
+            vertex_node.queued = true;
+            queued_vertices[num_queued++] = v;
+        }
+        vertex_node.queued_delta += delta;
+    }
+    void apply_queued_deltas(){
+        for(VertIndex v: unidom::array_range(queued_vertices,num_queued)){
+            PQVertex& vertex_node = vertices[v];
+            apply_delta(v, vertex_node.queued_delta);
+            vertex_node.queued_delta = 0;
+            vertex_node.queued = false;
+        }
+        num_queued = 0;
+    }
     
     
     
@@ -217,9 +293,11 @@ public:
     
 
     //Equivalent of DegreePQ_init from C version
-    DegreePQBase(Graph& g): G(g), head(head_tail.next), tail(head_tail.prev), n(G.n()){
+    DegreePQBase(Graph& g): G(g), head(head_tail.next), tail(head_tail.prev), n(G.n()), num_queued(0){
         
-        for(int i = 0; i < n; i++){
+        //Closed neighbourhoods (with the loops the solvers add) have up to n vertices,
+        //so there is a degree node for each of 0, 1, ..., n
+        for(int i = 0; i <= n; i++){
             nodes[i].deg = i;
         }
         
@@ -259,11 +337,15 @@ protected:
         PQNode *degree_node;
         VertIndex v;
         bool is_fixed, is_dominated;
+        bool queued; //True if v is in queued_vertices
+        int queued_delta;
         
         PQVertex(){
             next = prev = nullptr;
             degree_node = nullptr;
             is_fixed = is_dominated = false;
+            queued = false;
+            queued_delta = 0;
         }
     };
     struct PQNode{
@@ -293,9 +375,12 @@ protected:
     PQNode*& head; //Aliased to the next pointer of head_tail
     PQNode*& tail; 
     
-    std::array<PQNode, unidom::MAX_VERTS> nodes;
+    std::array<PQNode, unidom::MAX_VERTS+1> nodes;
     std::array<PQVertex, unidom::MAX_VERTS> vertices;
     
+    std::array<VertIndex, unidom::MAX_VERTS> queued_vertices;
+    int num_queued;
+    
 
     //splice_in and splice_out look weird because they were optimized to avoid any kind
     //of if-statements since they get called so often.
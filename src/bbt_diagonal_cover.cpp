@@ -0,0 +1,172 @@
+/*  bbt_diagonal_cover.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <array>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include "unidom_common.hpp"
+#include "bbt_line_cover.hpp"
+#include "graph_util.hpp"
+
+using std::string;
+using std::array;
+using std::vector;
+
+using unidom::Solver;
+using unidom::DominationInstance;
+
+
+//The diagonals solvers run the line cover search (see bbt_line_cover.hpp) on graphs
+//whose vertices are the cells of a board with two directions of lines, where two
+//cells are adjacent exactly when they share a line (such as the bishop graphs, with
+//their two directions of diagonals, or rook graphs). The lines are taken from the
+//edge clique cover of the instance, which must split into two directions with every
+//vertex on at most one line of each direction.
+//A cell is dominated when one of its two lines is occupied, so the search is a
+//covering problem on the lines: every undominated cell is an edge between its two
+//unoccupied lines, and each new dominator occupies at most one line of each
+//direction. Any set of lines which covers those edges has at least as many lines
+//as a maximum matching of them (by Konig's theorem), so at least half that many
+//dominators are still needed. This bound is used alongside the usual DD bound.
+struct DiagonalLines{
+    static const int LINES_PER_VERTEX = 2;
+
+    bool build(DominationInstance& inst, CliqueCover& lines){
+        int n = inst.G.n();
+        CliqueCover cover = instance_clique_cover(inst);
+
+        line_cells.clear();
+        vector< vector<int> > lines_of_cell(n);
+        for(auto& clique: cover){
+            if (clique.size() == 0)
+                continue;
+            for(VertIndex v: clique)
+                lines_of_cell[v].push_back(line_cells.size());
+            line_cells.push_back(vector<int>(clique.begin(), clique.end()));
+        }
+        for(int v = 0; v < n; v++)
+            if (lines_of_cell[v].size() > 2)
+                return false;
+
+        //2-colour the lines (two lines are joined when they share a cell)
+        line_direction.assign(line_cells.size(),-1);
+        for(unsigned int root = 0; root < line_cells.size(); root++){
+            if (line_direction[root] != -1)
+                continue;
+            line_direction[root] = 0;
+            vector<int> queue = {(int)root};
+            for(unsigned int i = 0; i < queue.size(); i++){
+                int l = queue[i];
+                for(int c: line_cells[l]){
+                    for(int l2: lines_of_cell[c]){
+                        if (l2 == l)
+                            continue;
+                        if (line_direction[l2] == line_direction[l])
+                            return false;
+                        if (line_direction[l2] == -1){
+                            line_direction[l2] = 1-line_direction[l];
+                            queue.push_back(l2);
+                        }
+                    }
+                }
+            }
+        }
+
+        //Cells missing a line in some direction get a line of their own
+        cell_lines.assign(n,array<int,2>{-1,-1});
+        for(int v = 0; v < n; v++){
+            for(int l: lines_of_cell[v])
+                cell_lines[v][line_direction[l]] = l;
+            for(int d = 0; d < 2; d++){
+                if (cell_lines[v][d] != -1)
+                    continue;
+                cell_lines[v][d] = line_cells.size();
+                line_cells.push_back({v});
+                line_direction.push_back(d);
+            }
+        }
+
+        //Two cells may not share both of their lines
+        std::set< std::pair<int,int> > line_pairs;
+        for(int v = 0; v < n; v++)
+            if (!line_pairs.insert({cell_lines[v][0], cell_lines[v][1]}).second)
+                return false;
+
+        lines.assign(line_cells.begin(), line_cells.end());
+        matched_cell.assign(line_cells.size(),-1);
+        visit_stamp.assign(line_cells.size(),0);
+        current_stamp = 0;
+        return true;
+    }
+    static string requirement(){
+        return "a graph whose clique cover splits into two directions of lines";
+    }
+
+    //Half of a maximum matching of the undominated cells (viewed as edges between lines)
+    int extra_lower_bound(VertexSet& undominated, vector<int>& undominated_on_line){
+        int matching_size = 0;
+        std::fill(matched_cell.begin(), matched_cell.end(), -1);
+        for(unsigned int l = 0; l < line_cells.size(); l++){
+            if (line_direction[l] != 0 || undominated_on_line[l] == 0)
+                continue;
+            current_stamp++;
+            if (augment(l,undominated))
+                matching_size++;
+        }
+        return (matching_size+1)/2;
+    }
+
+private:
+    vector< array<int,2> > cell_lines; //The line of each direction through each cell
+    vector< vector<int> > line_cells;
+    vector<int> line_direction;
+
+    //State for the matching bound (indexed by line)
+    vector<int> matched_cell; //For lines of direction 1, the cell matching it (or -1)
+    vector<unsigned int> visit_stamp;
+    unsigned int current_stamp;
+
+    //Augmenting path search from line l (of direction 0) over undominated cells
+    bool augment(int l, VertexSet& undominated){
+        for(int c: line_cells[l]){
+            if (!undominated.contains(c))
+                continue;
+            int l2 = cell_lines[c][1];
+            if (visit_stamp[l2] == current_stamp)
+                continue;
+            visit_stamp[l2] = current_stamp;
+            if (matched_cell[l2] == -1 || augment(cell_lines[matched_cell[l2]][0],undominated)){
+                matched_cell[l2] = c;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+namespace{
+    typedef LineCoverSolver<DiagonalLines,false> DiagonalCoverSolver;
+    typedef LineCoverSolver<DiagonalLines,true> DiagonalCoverSolver_all;
+}
+REGISTER_SOLVER( DiagonalCoverSolver, "diagonals", "Line covering solver with a matching bound for graphs made of two directions of lines, like bishop graphs (optimization)");
+REGISTER_SOLVER( DiagonalCoverSolver_all, "diagonals_all", "Line covering solver with a matching bound for graphs made of two directions of lines, like bishop graphs (generation)");
@@ -37,6 +37,9 @@ using unidom::MAX_VERTS;
 template<bool GENERATE_ALL>
 class BBTFixedOrderSolver: public BBTFrameworkSolver{
 public:
+    bool generates_all(){
+        return GENERATE_ALL;
+    }
     void solve(DominationInstance& inst, unidom::OutputProxy& output_proxy){
         /*
         Graph& G = inst.G;
@@ -88,7 +91,11 @@ public:
         reset_depth_log();
         
         output_proxy.initialize(inst);
-        FindDominatingSet<true>(G,0);
+        prepare_emitted_sets(n);
+        if (!GENERATE_ALL)
+            seed_incumbent(inst,output_proxy,B);
+        run_search(B, D.get_size(), [&]{ FindDominatingSet<true>(G,0); });
+        flush_emitted_sets(inst,output_proxy);
         output_proxy.finalize(inst);
         
         print_depth_log();
@@ -180,11 +187,12 @@ private:
         if (total_covered == n){
             if (GENERATE_ALL){
                 if (D.get_size() >= total_lower_bound && D.get_size() <= total_upper_bound)
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
             }else{
                 if (D.get_size() >= total_lower_bound && D.get_size() < B.get_size()){
                     B = D;
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
+                    check_lower_bound_hint(B.get_size());
                 }
             }
             return;
@@ -24,29 +24,47 @@
 #include <iomanip>
 #include <string>
 #include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
 #include "unidom_common.hpp"
+#include "unidom_alloc_tracking.hpp"
+#include "unidom_perf_counters.hpp"
 
 
 class BBTFrameworkSolver: public unidom::Solver{
 public:
     
     BBTFrameworkSolver(){
-        reset_depth_log();
         resmod_mod = 1;
         resmod_res = 0;
         resmod_depth = INVALID_DEPTH;
         total_upper_bound = unidom::MAX_VERTS;
         total_lower_bound = 0;
         verbose = false;
+        solution_batch_size = 0;
+        node_limit = NO_NODE_LIMIT;
+        deepen = false;
+        perf_enabled = false;
+        perf_band_width = 0;
+        perf_running = false;
+        perf_measured = false;
+        perf_track_bands = false;
+        reset_depth_log();
     }
     
     void duplicate_settings_only(BBTFrameworkSolver& other){
-        reset_depth_log();
         resmod_mod = other.resmod_mod;
         resmod_res = other.resmod_res;
         resmod_depth = other.resmod_depth;
         total_upper_bound = other.total_upper_bound;
         total_lower_bound = other.total_lower_bound;
+        solution_batch_size = other.solution_batch_size;
+        node_limit = other.node_limit;
+        deepen = other.deepen;
+        perf_enabled = other.perf_enabled;
+        perf_band_width = other.perf_band_width;
+        reset_depth_log();
     }
     
     bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
@@ -64,25 +82,87 @@ public:
             verbose = false;
         else if(arg == "-verbose")
             verbose = true;
-        else
+        else if(arg == "-batch")
+            solution_batch_size = parser.get_next_unsigned_int();
+        else if(arg == "-node_limit")
+            node_limit = parser.get_next_unsigned_int();
+        else if(arg == "-deepen")
+            deepen = true;
+        else if(arg == "-perf")
+            perf_enabled = true;
+        else if(arg == "-perf_bands"){
+            perf_enabled = true;
+            perf_band_width = parser.get_next_unsigned_int();
+            if (perf_band_width == 0)
+                throw unidom::ConfigurableError("Parameter -perf_bands must be at least 1.");
+        }else
             return unidom::Solver::accept_argument(arg,parser);
         return true;
     }
     
+    //Implemented by each search template (from its GENERATE_ALL parameter), so that the
+    //optimality and cacheability of the results never depend on the solver's name
+    virtual bool generates_all() = 0;
+    
+    unsigned long long search_node_count(){
+        unsigned long long total_count = 0;
+        for(auto count: depth_log)
+            total_count += count;
+        return total_count;
+    }
+    
+    //True if the last call to solve stopped early because of -node_limit
+    //(so the sets produced may not be optimal or complete).
+    bool search_was_aborted(){
+        return search_aborted;
+    }
+    
+    //An upper bound does not matter (any set found is still minimum), but a lower
+    //bound or resmod partitioning does. Stopping at the instance's lower bound hint
+    //does not either (no smaller set exists).
+    bool result_is_optimal(){
+        return !generates_all() && !search_aborted && total_lower_bound == 0 && resmod_mod == 1;
+    }
+    //Unlike result_is_optimal, an upper bound matters here: a cached set may be larger.
+    bool result_is_cacheable(){
+        return !generates_all() && total_lower_bound == 0 && total_upper_bound >= (unsigned int)unidom::MAX_VERTS && resmod_mod == 1;
+    }
     
 protected:
     
     
     void reset_depth_log(){
         depth_log.fill(0);
+        nodes_visited = 0;
+        node_stop = node_limit;
+        search_aborted = false;
+        lower_bound_hint = 0;
+        lower_bound_reached = false;
+#ifdef UNIDOM_TRACK_ALLOCATIONS
+        first_node_allocations = last_node_allocations = NO_ALLOCATION_COUNT;
+#endif
     }
     //Returns 0 if the current branch should be terminated for violating
     //the res/mod conditions, -1 if the current branch should continue but
     //may eventually violate the res/mod conditions, and 1 if the current branch
     //should continue and can avoid checking the conditions ever again.
+    //Once the node limit (or the lower bound hint) is reached, every later node is
+    //terminated (so the search unwinds through the usual resmod pruning path).
     template<bool check_resmod_depth>
     int report_node(int depth){
+        if (nodes_visited >= node_stop){
+            search_aborted = !lower_bound_reached;
+            return 0;
+        }
+        nodes_visited++;
         depth_log[(unsigned int)depth]++;
+        if (perf_track_bands)
+            note_perf_depth(depth);
+#ifdef UNIDOM_TRACK_ALLOCATIONS
+        last_node_allocations = unidom::allocation_count();
+        if (first_node_allocations == NO_ALLOCATION_COUNT)
+            first_node_allocations = last_node_allocations;
+#endif
         if (check_resmod_depth){
             if(depth == resmod_depth){
                 if((depth_log[(unsigned int)depth]-1)%resmod_mod == resmod_res)
@@ -98,11 +178,115 @@ protected:
         }
     }
     void unreport_node(int depth){
+        nodes_visited--;
         depth_log[(unsigned int)depth]--;
     }
     
+    //Sets found during the search should be passed to emit_set instead of directly to
+    //the output proxy. If batching is enabled (with -batch <size>), sets are copied into
+    //a compact buffer and handed to the output proxy in groups of the given size.
+    //Call prepare_emitted_sets after initializing the output proxy and
+    //flush_emitted_sets before finalizing it.
+    void prepare_emitted_sets(int n){
+        solution_batch.clear();
+        if (solution_batch_size > 0)
+            solution_batch.reserve(solution_batch_size, solution_batch_size*n);
+    }
+    void emit_set(unidom::DominationInstance& inst, unidom::OutputProxy& output_proxy, VertexSet& S){
+        if (solution_batch_size == 0){
+            output_proxy.process_set(inst,S);
+            return;
+        }
+        solution_batch.add(S);
+        if (solution_batch.size() >= solution_batch_size)
+            flush_emitted_sets(inst, output_proxy);
+    }
+    void flush_emitted_sets(unidom::DominationInstance& inst, unidom::OutputProxy& output_proxy){
+        if (solution_batch.empty())
+            return;
+        output_proxy.process_batch(inst,solution_batch);
+        solution_batch.clear();
+    }
+    
+    //Optimizing solvers call this after prepare_emitted_sets. If the instance carries a
+    //valid incumbent set smaller than B, it is output first and becomes B (so the search
+    //only looks for strictly smaller sets). The instance's lower bound hint is also
+    //picked up here (see check_lower_bound_hint).
+    void seed_incumbent(unidom::DominationInstance& inst, unidom::OutputProxy& output_proxy, VertexSet& B){
+        using unidom::log;
+        lower_bound_hint = inst.lower_bound_hint;
+        VertexSet& incumbent = inst.incumbent;
+        if (incumbent.get_size() > 0 && incumbent.get_size() < B.get_size() && incumbent.get_size() >= total_lower_bound){
+            if (unidom::is_dominating_set(inst,incumbent)){
+                log << "Starting from an incumbent of size " << incumbent.get_size() << std::endl;
+                B = incumbent;
+                emit_set(inst,output_proxy,B);
+                check_lower_bound_hint(B.get_size());
+            }else{
+                log << "Ignoring an invalid incumbent" << std::endl;
+            }
+        }
+    }
+    //Runs the search (after seed_incumbent). With -deepen, an optimizing search is instead
+    //repeated for each target size k = 1, 2, ... (starting from -l, the lower bound hint
+    //and the number of vertices already in the set when the search starts), with B
+    //temporarily replaced by a placeholder of size k+1, so that everything which cannot
+    //reach size k is pruned. The first k for which a set is found is the minimum. Smaller
+    //sizes have already been ruled out by then, so k is also the lower bound hint of its
+    //iteration, which therefore stops at its first set. Every search restores the solver
+    //state when it returns, so all iterations share the setup (and targets below the
+    //bound at the root fail at the root).
+    //With -perf, the hardware counters run for the whole search (see print_perf_counters).
+    template<typename SearchFunction>
+    void run_search(VertexSet& B, unsigned int initial_size, SearchFunction search){
+        start_perf_counters();
+        run_search_iterations(B, initial_size, search);
+        stop_perf_counters();
+    }
+    template<typename SearchFunction>
+    void run_search_iterations(VertexSet& B, unsigned int initial_size, SearchFunction search){
+        if (!deepen || generates_all()){
+            search();
+            return;
+        }
+        unsigned int incumbent_size = B.get_size();
+        VertexSet incumbent = B;
+        unsigned int hint = lower_bound_hint;
+        unsigned int k = std::max({1u, initial_size, total_lower_bound, lower_bound_hint});
+        for(; k < incumbent_size && !search_aborted && !lower_bound_reached; k++){
+            B.reset_full(k+1);
+            lower_bound_hint = k;
+            search();
+            if (B.get_size() <= k){
+                unidom::log << "Deepening: found a set of size " << B.get_size() << std::endl;
+                return;
+            }
+        }
+        lower_bound_hint = hint;
+        B = incumbent;
+    }
+    
+    //Called whenever B improves: once B reaches the lower bound hint, no smaller set
+    //exists, so the rest of the search is skipped.
+    void check_lower_bound_hint(unsigned int best_size){
+        if (best_size <= lower_bound_hint && !lower_bound_reached){
+            lower_bound_reached = true;
+            node_stop = 0;
+            unidom::log << "Reached the lower bound hint (" << lower_bound_hint << ")" << std::endl;
+        }
+    }
+    
     void print_depth_log(){
         using unidom::log;
+#ifdef UNIDOM_TRACK_ALLOCATIONS
+        //Every allocation between the first and last node of the search is reported
+        //(the search itself is expected to be allocation-free).
+        if (first_node_allocations != NO_ALLOCATION_COUNT)
+            unidom::report_hot_path_allocations(name(), last_node_allocations - first_node_allocations);
+#endif
+        if (search_aborted)
+            log << "Search stopped at the node limit (" << node_limit << " nodes)" << std::endl;
+        print_perf_counters();
         if (!verbose)
             return;
         log << "Depth Log:" << std::endl;
@@ -119,6 +303,101 @@ protected:
         log<<"Total Logged Calls: "<<total_count<<std::endl;
     }
     
+    //Hardware counters for the search (-perf), reported as totals and per search node.
+    //With -perf_bands W, the counts are also split into bands of W depths: the counters
+    //are read whenever the search enters a node in a different band from the last one, and
+    //the events since the last read are charged to the band of the last node entered
+    //(so work done on returning to a shallower node is charged to the deeper band).
+    void start_perf_counters(){
+        perf_running = perf_measured = perf_track_bands = false;
+        if (!perf_enabled)
+            return;
+        if (!perf_counters)
+            perf_counters = std::make_unique<unidom::PerfCounters>();
+        if (!perf_counters->open())
+            return;
+        unidom::PerfCounters::Values zero;
+        zero.fill(0);
+        perf_band_totals.assign((perf_band_width > 0)? unidom::MAX_VERTS/perf_band_width+1 : 0, zero);
+        perf_band = -1;
+        perf_last_values = zero;
+        perf_running = true;
+        perf_track_bands = perf_band_width > 0;
+        perf_counters->start();
+    }
+    void stop_perf_counters(){
+        if (!perf_running)
+            return;
+        perf_counters->stop();
+        perf_counters->read(perf_totals);
+        if (perf_band >= 0)
+            add_perf_band_counts(perf_totals);
+        perf_running = perf_track_bands = false;
+        perf_measured = true;
+    }
+    void note_perf_depth(int depth){
+        int band = depth/perf_band_width;
+        if (band == perf_band)
+            return;
+        unidom::PerfCounters::Values values;
+        perf_counters->read(values);
+        if (perf_band >= 0)
+            add_perf_band_counts(values);
+        perf_last_values = values;
+        perf_band = band;
+    }
+    void add_perf_band_counts(unidom::PerfCounters::Values& values){
+        for(int i = 0; i < unidom::PerfCounters::NUM_COUNTERS; i++)
+            perf_band_totals[perf_band][i] += values[i] - perf_last_values[i];
+    }
+    void print_perf_counters(){
+        using unidom::log;
+        if (!perf_measured)
+            return;
+        std::ios_base::fmtflags flags = log.flags();
+        std::streamsize precision = log.precision();
+        log << std::fixed;
+        print_perf_counter_tables();
+        log.flags(flags);
+        log.precision(precision);
+    }
+    void print_perf_counter_tables(){
+        using unidom::log;
+        using unidom::PerfCounters;
+        unsigned long long nodes = std::max(1ull, search_node_count());
+        log << "Performance counters (" << search_node_count() << " search nodes):" << std::endl;
+        for(int i = 0; i < PerfCounters::NUM_COUNTERS; i++){
+            log << "  " << std::setw(16) << std::left << PerfCounters::counter_name(i)+":" << std::right;
+            if (perf_counters->available(i))
+                log << std::setw(16) << perf_totals[i] << " (" << std::setprecision(1) << (double)perf_totals[i]/nodes << " per node)" << std::endl;
+            else
+                log << std::setw(16) << "n/a" << std::endl;
+        }
+        if (perf_counters->available(PerfCounters::CYCLES) && perf_counters->available(PerfCounters::INSTRUCTIONS) && perf_totals[PerfCounters::CYCLES] > 0)
+            log << "  " << std::setw(16) << std::left << "IPC:" << std::right << std::setw(16) << std::setprecision(2)
+                << (double)perf_totals[PerfCounters::INSTRUCTIONS]/perf_totals[PerfCounters::CYCLES] << std::endl;
+        if (perf_band_width == 0)
+            return;
+        log << "Performance counters per node by depth:" << std::endl;
+        log << "   depths        nodes";
+        for(int i = 0; i < PerfCounters::NUM_COUNTERS; i++)
+            if (perf_counters->available(i))
+                log << std::setw(17) << PerfCounters::counter_name(i);
+        log << std::endl;
+        for(unsigned int band = 0; band < perf_band_totals.size(); band++){
+            unsigned long long band_nodes = 0;
+            for(unsigned int d = band*perf_band_width; d < (band+1)*perf_band_width && d < (unsigned int)unidom::MAX_VERTS; d++)
+                band_nodes += depth_log[d];
+            if (band_nodes == 0)
+                continue;
+            log << std::setw(4) << band*perf_band_width << "-" << std::setw(4) << std::left << (band+1)*perf_band_width-1 << std::right << std::setw(12) << band_nodes;
+            for(int i = 0; i < PerfCounters::NUM_COUNTERS; i++)
+                if (perf_counters->available(i))
+                    log << std::setw(17) << std::setprecision(1) << (double)perf_band_totals[band][i]/band_nodes;
+            log << std::endl;
+        }
+    }
+    
     const unsigned int INVALID_DEPTH = (unsigned int)(-1);
     
     unsigned int resmod_mod;
@@ -130,6 +409,33 @@ protected:
     
     std::array<unsigned long long int, unidom::MAX_VERTS> depth_log;
     
+#ifdef UNIDOM_TRACK_ALLOCATIONS
+    static const unsigned long long NO_ALLOCATION_COUNT = (unsigned long long)(-1);
+    unsigned long long first_node_allocations, last_node_allocations;
+#endif
+    
+    static const unsigned long long NO_NODE_LIMIT = (unsigned long long)(-1);
+    unsigned long long node_limit; //Maximum number of search nodes visited by each call to solve
+    unsigned long long nodes_visited;
+    unsigned long long node_stop; //Node count at which the search stops (node_limit, or 0 once the lower bound hint is reached)
+    bool search_aborted;
+    
+    unsigned int lower_bound_hint;
+    bool lower_bound_reached;
+    
+    bool deepen; //Search for sets of each size in increasing order (with -deepen)
+    
+    bool perf_enabled; //Count hardware events during the search (with -perf)
+    unsigned int perf_band_width; //Depths per band for -perf_bands (0 for totals only)
+    std::unique_ptr<unidom::PerfCounters> perf_counters; //Opened on first use
+    bool perf_running, perf_measured, perf_track_bands;
+    unidom::PerfCounters::Values perf_totals, perf_last_values;
+    std::vector<unidom::PerfCounters::Values> perf_band_totals;
+    int perf_band; //Band of the last node entered (-1 before the first node)
+    
+    unsigned int solution_batch_size; //0 if sets are passed to the output proxy one at a time
+    unidom::SolutionBatch solution_batch;
+    
     bool verbose;
     
     
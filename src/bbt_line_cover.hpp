@@ -0,0 +1,416 @@
+/*  bbt_line_cover.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_LINE_COVER_H
+#define BBT_LINE_COVER_H
+
+#include <string>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "unidom_common.hpp"
+#include "unidom_arrayutil.hpp"
+#include "bbt_framework.hpp"
+#include "graph_util.hpp"
+
+
+//The edge clique cover of the instance, or a greedy cover if the instance has none.
+inline CliqueCover instance_clique_cover(unidom::DominationInstance& inst){
+    if (inst.clique_cover.size() == 0)
+        return greedy_clique_cover(inst.G);
+    if (!is_clique_cover(inst.G,inst.clique_cover))
+        throw unidom::ConfigurableError("The clique cover of the instance is not a valid edge clique cover.");
+    return inst.clique_cover;
+}
+
+//Base class for the line policies of LineCoverSolver, for covers with no bound
+//beyond the domination degree bound and any number of lines through each vertex.
+struct LineCoverPolicy{
+    static const int LINES_PER_VERTEX = 0;
+    int extra_lower_bound(VertexSet& /*undominated*/, std::vector<int>& /*undominated_on_line*/){
+        return 0;
+    }
+};
+
+
+//A DD-style solver which works on a set of "lines" (cliques which together cover
+//every edge of the graph) instead of the neighbour lists. Each line keeps a count
+//of the dominators, undominated vertices and candidates it contains, and a vertex
+//is dominated exactly when one of its lines contains a dominator, so adding a
+//dominator only visits the members of lines which had no dominator before.
+//The domination degree of a candidate v is estimated as
+//  (sum of undominated counts of the lines containing v) - (k-1)*[v is undominated]
+//where k is the number of lines containing v. This is exact when the lines
+//through each vertex only meet at that vertex (as on the boards), and otherwise
+//overestimates, which keeps the bound valid.
+//The lines come from the LinePolicy, which provides
+//  bool build(DominationInstance& inst, CliqueCover& lines)
+//    Fills in the lines (which must be an edge clique cover of inst.G), or
+//    returns false if the instance is not of the kind the policy handles.
+//  static std::string requirement()
+//    Describes the instances the policy handles (for the error message).
+//  int extra_lower_bound(VertexSet& undominated, std::vector<int>& undominated_on_line)
+//    A lower bound on the number of additional dominators needed, which is only
+//    computed if the domination degree bound passes (see LineCoverPolicy).
+//  static const int LINES_PER_VERTEX
+//    The number of lines through every vertex, or 0 if it varies. A fixed number
+//    lets the compiler unroll the loops over the lines of a vertex.
+//Line l of the policy keeps index l in undominated_on_line. Vertices in no line
+//get a singleton line after them.
+template<typename LinePolicy, bool GENERATE_ALL>
+class LineCoverSolver: public BBTFrameworkSolver{
+public:
+    bool generates_all(){
+        return GENERATE_ALL;
+    }
+    void solve(unidom::DominationInstance& inst, unidom::OutputProxy& output_proxy){
+        dom_inst = &inst;
+        this->output_proxy = &output_proxy;
+        int n = inst.G.n();
+
+        CliqueCover cover;
+        if (!policy.build(inst,cover))
+            throw unidom::ConfigurableError("Solver \""+name()+"\" requires "+LinePolicy::requirement()+".");
+        build_lines(inst.G,cover);
+
+        D.reset();
+        B.reset_full(n-1);
+
+        if (!GENERATE_ALL && total_upper_bound < n)
+            B.reset_full(total_upper_bound+1);
+
+        dominators_on_line.assign(num_lines,0);
+        undominated_on_line.assign(num_lines,0);
+        candidates_on_line.assign(num_lines,0);
+        for(int l = 0; l < num_lines; l++)
+            undominated_on_line[l] = candidates_on_line[l] = line_start[l+1] - line_start[l];
+        fixed.fill(0);
+        total_fixed = 0;
+        undominated.reset_full(n);
+        marks.assign(n,0);
+        current_mark = 0;
+
+        //Add all of the "force_in" vertices to the dominating set
+        for(VertIndex v: inst.force_in){
+            fix_vertex(v);
+            add_dominator(v);
+        }
+        //Set all of the "force_out" vertices to be forbidden
+        for(VertIndex v: inst.force_out)
+            fix_vertex(v);
+
+        reset_depth_log();
+
+        output_proxy.initialize(inst);
+        prepare_emitted_sets(n);
+        if (!GENERATE_ALL)
+            seed_incumbent(inst,output_proxy,B);
+        run_search(B, D.get_size(), [&]{ FindDominatingSet<true>(); });
+        flush_emitted_sets(inst,output_proxy);
+        output_proxy.finalize(inst);
+
+        print_depth_log();
+    }
+
+private:
+    unidom::DominationInstance* dom_inst;
+    unidom::OutputProxy* output_proxy;
+    LinePolicy policy;
+
+    VertexSet D; //Current working set
+    VertexSet B; //Best set found so far
+
+    //Line l contains line_members[line_start[l]] to line_members[line_start[l+1]-1],
+    //and vertex v is contained in vertex_lines[vertex_start[v]] to vertex_lines[vertex_start[v+1]-1]
+    int num_lines;
+    std::vector<int> line_start, line_members;
+    std::vector<int> vertex_start, vertex_lines;
+    int max_degree_estimate;
+    bool lines_meet_once; //True if the lines through each vertex only meet at that vertex
+
+    std::vector<int> dominators_on_line, undominated_on_line, candidates_on_line;
+    std::array<int,unidom::MAX_VERTS> fixed;
+    int total_fixed;
+    VertexSet undominated;
+    std::vector<int> degree_counts;
+
+    std::vector<unsigned int> marks; //Used to collect the distinct candidates of a vertex
+    unsigned int current_mark;
+
+    void build_lines(Graph& G, CliqueCover& cover){
+        int n = G.n();
+        std::vector< std::vector<int> > lines;
+        std::vector<int> lines_through(n,0);
+        for(auto& line: cover){
+            lines.push_back(std::vector<int>(line.begin(), line.end()));
+            for(VertIndex v: line)
+                lines_through[v]++;
+        }
+        for(int v = 0; v < n; v++)
+            if (lines_through[v] == 0)
+                lines.push_back({v});
+
+        num_lines = lines.size();
+        line_start.assign(1,0);
+        line_members.clear();
+        std::vector< std::vector<int> > lines_of_vertex(n);
+        for(int l = 0; l < num_lines; l++){
+            for(int v: lines[l]){
+                line_members.push_back(v);
+                lines_of_vertex[v].push_back(l);
+            }
+            line_start.push_back(line_members.size());
+        }
+        vertex_start.assign(1,0);
+        vertex_lines.clear();
+        max_degree_estimate = 0;
+        lines_meet_once = true;
+        for(int v = 0; v < n; v++){
+            int estimate = 1 - (int)lines_of_vertex[v].size();
+            for(int l: lines_of_vertex[v]){
+                vertex_lines.push_back(l);
+                estimate += line_start[l+1] - line_start[l];
+            }
+            vertex_start.push_back(vertex_lines.size());
+            assert(LinePolicy::LINES_PER_VERTEX == 0 || (int)lines_of_vertex[v].size() == LinePolicy::LINES_PER_VERTEX);
+            max_degree_estimate = std::max(max_degree_estimate, estimate);
+            //Since the lines cover every edge, the estimate counts each neighbour at least once
+            if (estimate != G[v].deg()+1)
+                lines_meet_once = false;
+        }
+        degree_counts.assign(max_degree_estimate+1,0);
+    }
+
+    const int* lines_begin(int v){
+        if (LinePolicy::LINES_PER_VERTEX > 0)
+            return vertex_lines.data() + LinePolicy::LINES_PER_VERTEX*v;
+        return vertex_lines.data() + vertex_start[v];
+    }
+    const int* lines_end(int v){
+        if (LinePolicy::LINES_PER_VERTEX > 0)
+            return lines_begin(v) + LinePolicy::LINES_PER_VERTEX;
+        return vertex_lines.data() + vertex_start[v+1];
+    }
+    const int* members_begin(int l){
+        return line_members.data() + line_start[l];
+    }
+    const int* members_end(int l){
+        return line_members.data() + line_start[l+1];
+    }
+    int line_count(int v){
+        if (LinePolicy::LINES_PER_VERTEX > 0)
+            return LinePolicy::LINES_PER_VERTEX;
+        return vertex_start[v+1] - vertex_start[v];
+    }
+
+    bool is_dominated(int v){
+        for(const int* l = lines_begin(v); l != lines_end(v); l++)
+            if (dominators_on_line[*l] > 0)
+                return true;
+        return false;
+    }
+    int domination_degree(int v){
+        int result = undominated.contains(v)? 1 - line_count(v) : 0;
+        for(const int* l = lines_begin(v); l != lines_end(v); l++)
+            result += undominated_on_line[*l];
+        return result;
+    }
+    int candidate_degree(int v){
+        int result = fixed[v]? 0 : 1 - line_count(v);
+        for(const int* l = lines_begin(v); l != lines_end(v); l++)
+            result += candidates_on_line[*l];
+        return result;
+    }
+
+    void add_dominator(int v){
+        D.add(v);
+        for(const int* l = lines_begin(v); l != lines_end(v); l++){
+            if (dominators_on_line[*l]++ > 0)
+                continue;
+            //Any undominated members of a line which had no dominator are now dominated
+            for(const int* x = members_begin(*l); x != members_end(*l); x++){
+                if (!undominated.contains(*x))
+                    continue;
+                undominated.remove(*x);
+                for(const int* l2 = lines_begin(*x); l2 != lines_end(*x); l2++)
+                    undominated_on_line[*l2]--;
+            }
+        }
+    }
+    void remove_dominator(int v){
+        for(const int* l = lines_end(v)-1; l >= lines_begin(v); l--){
+            if (--dominators_on_line[*l] > 0)
+                continue;
+            for(const int* x = members_begin(*l); x != members_end(*l); x++){
+                if (undominated.contains(*x) || is_dominated(*x))
+                    continue;
+                undominated.add(*x);
+                for(const int* l2 = lines_begin(*x); l2 != lines_end(*x); l2++)
+                    undominated_on_line[*l2]++;
+            }
+        }
+        D.remove_pop(v);
+    }
+
+    //Returns true if some undominated vertex is left with no candidates
+    //(in which case v must be in the dominating set).
+    bool fix_vertex(int v){
+        assert(!fixed[v]);
+        fixed[v] = 1;
+        total_fixed++;
+        for(const int* l = lines_begin(v); l != lines_end(v); l++)
+            candidates_on_line[*l]--;
+        for(const int* l = lines_begin(v); l != lines_end(v); l++){
+            if (undominated_on_line[*l] == 0)
+                continue;
+            for(const int* x = members_begin(*l); x != members_end(*l); x++)
+                if (undominated.contains(*x) && candidate_degree(*x) == 0)
+                    return true;
+        }
+        return false;
+    }
+    void unfix_vertex(int v){
+        assert(fixed[v]);
+        fixed[v] = 0;
+        total_fixed--;
+        for(const int* l = lines_begin(v); l != lines_end(v); l++)
+            candidates_on_line[*l]++;
+    }
+
+    //Lower bound on the number of additional dominators needed (as in the DD solver)
+    int count_minimum_to_dominate(){
+        int n = dom_inst->G.n();
+        int m = undominated.get_size();
+        std::fill(degree_counts.begin(), degree_counts.end(), 0);
+        for(int v = 0; v < n; v++)
+            if (!fixed[v])
+                degree_counts[domination_degree(v)]++;
+        int count = 0;
+        for(int deg = max_degree_estimate; deg > 0 && m > 0; deg--){
+            int needed = (m+deg-1)/deg;
+            if (needed <= degree_counts[deg])
+                return count + needed;
+            count += degree_counts[deg];
+            m -= deg*degree_counts[deg];
+        }
+        return (m > 0)? unidom::MAX_VERTS+1 : count;
+    }
+
+    bool bounds_satisfied(){
+        int n = dom_inst->G.n();
+        int limit = GENERATE_ALL? total_upper_bound - D.get_size() : B.get_size() - D.get_size() - 1;
+        int min_vertices_needed = count_minimum_to_dominate();
+        if (min_vertices_needed > limit || n - total_fixed < min_vertices_needed)
+            return false;
+        min_vertices_needed = policy.extra_lower_bound(undominated,undominated_on_line);
+        if (min_vertices_needed > limit || n - total_fixed < min_vertices_needed)
+            return false;
+        return true;
+    }
+
+    template<bool check_resmod_depth>
+    void FindDominatingSet(){
+        int resmod_check = report_node<check_resmod_depth>(D.get_size());
+        if (resmod_check == 0)
+            return;
+        else if (check_resmod_depth && resmod_check == 1){
+            unreport_node(D.get_size());
+            FindDominatingSet<false>();
+            return;
+        }
+
+        if (undominated.get_size() == 0){
+            if (GENERATE_ALL){
+                if (D.get_size() >= total_lower_bound && D.get_size() <= total_upper_bound)
+                    emit_set(*dom_inst,*output_proxy,D);
+            }else{
+                if (D.get_size() >= total_lower_bound && D.get_size() < B.get_size()){
+                    B = D;
+                    emit_set(*dom_inst,*output_proxy,D);
+                    check_lower_bound_hint(B.get_size());
+                }
+            }
+            return;
+        }
+
+        //Choose the undominated vertex with the fewest candidates
+        int i = -1;
+        int min_cd = unidom::MAX_VERTS;
+        for(int v: undominated){
+            int cd = candidate_degree(v);
+            if (cd < min_cd){
+                min_cd = cd;
+                i = v;
+            }
+        }
+        if (min_cd == 0)
+            return;
+
+        if (!bounds_satisfied())
+            return;
+
+        //Rank the (distinct) candidates which dominate i by decreasing domination degree
+        struct RankedCandidate{
+            int degree;
+            int v;
+        };
+        RankedCandidate candidate_array[dom_inst->G[i].deg()+1]; //Standard C, but not standard C++
+        int candidate_count = 0;
+        if (lines_meet_once){
+            //Only i itself appears on more than one line
+            if (!fixed[i])
+                candidate_array[candidate_count++] = {domination_degree(i), i};
+            for(const int* l = lines_begin(i); l != lines_end(i); l++)
+                for(const int* x = members_begin(*l); x != members_end(*l); x++)
+                    if (*x != i && !fixed[*x])
+                        candidate_array[candidate_count++] = {domination_degree(*x), *x};
+        }else{
+            current_mark++;
+            for(const int* l = lines_begin(i); l != lines_end(i); l++){
+                for(const int* x = members_begin(*l); x != members_end(*l); x++){
+                    if (fixed[*x] || marks[*x] == current_mark)
+                        continue;
+                    marks[*x] = current_mark;
+                    candidate_array[candidate_count++] = {domination_degree(*x), *x};
+                }
+            }
+        }
+        unidom::insertion_sort(candidate_array, candidate_array+candidate_count, [](const RankedCandidate& a, const RankedCandidate& b){
+            return a.degree > b.degree;
+        });
+
+        int num_fixed = 0;
+        for(int q = 0; q < candidate_count; q++){
+            int j = candidate_array[q].v;
+            bool force_stop = fix_vertex(j);
+            num_fixed++;
+            add_dominator(j);
+            FindDominatingSet<check_resmod_depth>();
+            remove_dominator(j);
+            if (force_stop)
+                break;
+        }
+
+        for(int q = 0; q < num_fixed; q++)
+            unfix_vertex(candidate_array[q].v);
+    }
+};
+
+#endif
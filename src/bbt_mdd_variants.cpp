@@ -21,12 +21,18 @@
 #include <array>
 #include <vector>
 #include <algorithm>
+#include <memory>
 #include <cassert>
 #include "unidom_common.hpp"
 #include "unidom_arrayutil.hpp"
 #include "bbt_framework.hpp"
 #include "bbt_degreepq.hpp"
 #include "bbt_mddstack.hpp"
+#include "bbt_worker_team.hpp"
+#include "bbt_activity.hpp"
+#include "bbt_nogoods.hpp"
+#include "bbt_bound_audit.hpp"
+#include "bbt_policy_dispatch.hpp"
 #include "graph_util.hpp"
 
 using std::array;
@@ -59,6 +65,27 @@ class BBTMDDSolverVariant: public BBTFrameworkSolver{
     static_assert( CHOOSE_VERTEX_RULE <= CHOOSE_VERTEX_MAX_CD, "CHOOSE_VERTEX_RULE must be either CHOOSE_VERTEX_MIN_CD or CHOOSE_VERTEX_MAX_CD" );
     static_assert( RANK_NEIGHBOURS_RULE <= RANK_NEIGHBOURS_DESCENDING, "RANK_NEIGHBOURS_RULE must be either RANK_NEIGHBOURS_ASCENDING or RANK_NEIGHBOURS_DESCENDING" );
 public:
+    BBTMDDSolverVariant(): activity_enabled(false), activity_decay(0.95), team_size(1), team_threshold(DEFAULT_TEAM_THRESHOLD) {}
+    bool generates_all(){
+        return GENERATE_ALL;
+    }
+    
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-activity")
+            activity_enabled = true;
+        else if (arg == "-activity_decay")
+            activity_decay = parser.get_next_double();
+        else if (arg == "-team"){
+            team_size = parser.get_next_unsigned_int();
+            if (team_size == 0)
+                throw unidom::ConfigurableError("Parameter -team must be at least 1.");
+        }else if (arg == "-team_threshold")
+            team_threshold = parser.get_next_unsigned_int();
+        else if (!audit.accept_argument(arg,parser) && !analysis.accept_argument(arg,parser))
+            return BBTFrameworkSolver::accept_argument(arg,parser);
+        return true;
+    }
+    
     void solve(DominationInstance& inst, unidom::OutputProxy& output_proxy){
 
         dom_inst = &inst;
@@ -101,6 +128,11 @@ public:
         
         //The MDD_Stack is so huge, it will break the stack size limit
         mdd_stack = new MDDStack(G,CandidateNeighbours,UndominatedSet,UD_DPQ);
+        std::unique_ptr<WorkerTeam> team;
+        if (team_size > 1){
+            team = std::make_unique<WorkerTeam>(team_size);
+            mdd_stack->set_team(team.get(), team_threshold);
+        }
         
         //Add all of the "force_in" vertices to the dominating set
         
@@ -111,6 +143,7 @@ public:
             for(VertIndex u: G[v].neighbours()){
                 dominate(G,u);
             }
+            UndominatedDPQ->apply_queued_deltas();
             mdd_stack->add_dominator(v);
         }	
         
@@ -124,10 +157,24 @@ public:
         
         
         
+        activity.reset(n, activity_decay);
+        branch_vertex = Graph::INVALID_VERTEX;
+        
         reset_depth_log();
         
         output_proxy.initialize(inst);
-        FindDominatingSet<true>(G);
+        prepare_emitted_sets(n);
+        if (!GENERATE_ALL)
+            seed_incumbent(inst,output_proxy,B);
+        audit.start(name(), n);
+        analysis.start(inst);
+        run_search(B, D.get_size(), [&]{
+            analysis.start_search();
+            FindDominatingSet<true>(G);
+        });
+        audit.finish();
+        analysis.finish(verbose);
+        flush_emitted_sets(inst,output_proxy);
         output_proxy.finalize(inst);
         
         print_depth_log();
@@ -149,8 +196,27 @@ private:
     VertexSet UndominatedSet;
     MDDStack* mdd_stack;
     
-    array<int,MAX_VERTS> covered, fixed;
+    array<StoredVertCount,MAX_VERTS> covered, fixed;
     int total_covered, total_fixed;
+    
+    //Adaptive vertex choice (enabled with -activity), as in the DD solver: a bound failure
+    //bumps the vertex being dominated by the branch that led to it, and a vertex with no
+    //candidates left is bumped itself. Vertices with at most one candidate are chosen
+    //first, then the most active undominated vertex (ties broken by CHOOSE_VERTEX_RULE).
+    bool activity_enabled;
+    double activity_decay;
+    VertexActivity activity;
+    VertIndex branch_vertex;
+    
+    //With -team T, the MDD recomputations of each search node are split across T threads
+    //(see WorkerTeam) whenever at least -team_threshold vertices need them
+    static const int DEFAULT_TEAM_THRESHOLD = 256;
+    unsigned int team_size;
+    unsigned int team_threshold;
+    
+    BoundAudit audit; //Samples the tightness of the bound (with -audit)
+    
+    ConflictAnalysis analysis; //Nogoods and backjumping (with -nogoods)
         
     void sort_neighbours_descending(Graph& G){
         auto cmp = [&G](const VertIndex &a, const VertIndex &b){
@@ -212,7 +278,7 @@ private:
         UndominatedDPQ->dominate(v);
         UndominatedSet.remove(v);
         for(VertIndex u: G[v].neighbours())
-            UndominatedDPQ->decrement(u);
+            UndominatedDPQ->queue_delta(u,-1);
     }
     void undominate(Graph& G, VertIndex v){
         covered[v]--;
@@ -223,7 +289,7 @@ private:
         UndominatedDPQ->undominate(v);
         UndominatedSet.add(v);
         for(VertIndex u: G[v].neighbours()) //Congruent to original, but should be reversed
-            UndominatedDPQ->increment(u);
+            UndominatedDPQ->queue_delta(u,1);
             
     }
     
@@ -238,6 +304,7 @@ private:
         for(VertIndex k: G[j].neighbours()){
             dominate(G, k);
         }
+        UndominatedDPQ->apply_queued_deltas();
         
         mdd_stack->add_dominator(j);
         //FindDominatingSets returns 0 if it bounds out fatally, in which case
@@ -245,8 +312,10 @@ private:
         //until we unwind).
         //FindDominatingSets returns -1 if it bounds out non-fatally (i.e. if the bound is not
         //necessarily going to be violated until we unwind).
-        if (FindDominatingSet<check_resmod_depth>(G) == 0){
-            forced = true;
+        if (!analysis.is_enabled() || !analysis.prune(NogoodDatabase::in_literal(j), D, fixed, analysis.conflict(D.get_size()))){
+            if (FindDominatingSet<check_resmod_depth>(G) == 0){
+                forced = true;
+            }
         }
         
         mdd_stack->remove_dominator(j);
@@ -254,6 +323,7 @@ private:
         for(VertIndex k: iterate_reverse(G[j].neighbours())){
             undominate(G, k);
         }
+        UndominatedDPQ->apply_queued_deltas();
                 
         D.remove_pop(j);
         
@@ -362,6 +432,51 @@ private:
         return 1;
     }
     
+    //The bound fails at once if some undominated vertex has no candidates left (MDD 0),
+    //and that vertex alone explains it. A shortage of candidates depends on every fixed
+    //vertex.
+    void explain_bound(Graph& G, ConflictSet& conflict){
+        for(VertIndex u: UndominatedSet)
+            if (CandidateNeighbours[u].get_size() == 0){
+                analysis.explain_trapped_vertex(G, u, conflict);
+                return;
+            }
+        if (G.n() - total_fixed + 1 <= mdd_stack->min_vertices_needed())
+            analysis.explain_fixed(G.n(), fixed, conflict);
+        else
+            analysis.explain_bound(G, D, covered, fixed, conflict);
+    }
+    
+    void record_failure(VertIndex v){
+        if (!activity_enabled || v == Graph::INVALID_VERTEX)
+            return;
+        activity.bump(v);
+        activity.decay();
+    }
+    VertIndex choose_active_vertex(Graph& G){
+        VertIndex min_cd_vertex = Graph::INVALID_VERTEX;
+        int min_cd = unidom::MAX_VERTS;
+        for(VertIndex v: UndominatedSet){
+            if (CandidateNeighbours[v].get_size() < min_cd){
+                min_cd = CandidateNeighbours[v].get_size();
+                min_cd_vertex = v;
+            }
+        }
+        if (min_cd <= 1)
+            return min_cd_vertex;
+        VertIndex v = activity.choose([this](VertIndex u){ return covered[u] == 0; }, [this](VertIndex a, VertIndex b){
+            if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_MDD)
+                return mdd_stack->get_mdd(a) < mdd_stack->get_mdd(b);
+            else if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MAX_MDD)
+                return mdd_stack->get_mdd(a) > mdd_stack->get_mdd(b);
+            else if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_CD)
+                return CandidateNeighbours[a].get_size() < CandidateNeighbours[b].get_size();
+            else
+                return CandidateNeighbours[a].get_size() > CandidateNeighbours[b].get_size();
+        });
+        return (v == Graph::INVALID_VERTEX)? choose_next_vertex(G) : v;
+    }
+    
     VertIndex choose_next_vertex(Graph& G){
         if (CHOOSE_VERTEX_RULE == CHOOSE_VERTEX_MIN_MDD){
             //Find a vertex with maximum MDD
@@ -402,8 +517,11 @@ private:
     template<bool check_resmod_depth>
     int FindDominatingSet(Graph& G){
         int resmod_check = report_node<check_resmod_depth>(D.get_size());
-        if (resmod_check == 0)
+        if (resmod_check == 0){
+            if (analysis.is_enabled())
+                analysis.conflict(D.get_size()).set_all();
             return 1;
+        }
         else if (check_resmod_depth && resmod_check == 1){
             unreport_node(D.get_size());
             return FindDominatingSet<false>(G);
@@ -414,21 +532,36 @@ private:
         if (total_covered == n){
             if (GENERATE_ALL){
                 if (D.get_size() >= total_lower_bound && D.get_size() <= total_upper_bound)
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
             }else{
                 if (D.get_size() >= total_lower_bound && D.get_size() < B.get_size()){
                     B = D;
-                    output_proxy->process_set(*dom_inst,D);
+                    emit_set(*dom_inst,*output_proxy,D);
+                    check_lower_bound_hint(B.get_size());
                 }
             }
+            if (analysis.is_enabled()){
+                //Unless its supersets could still be output, no set containing D is better
+                bool supersets_wanted = GENERATE_ALL? D.get_size() <= total_upper_bound : D.get_size() < total_lower_bound;
+                analysis.explain_complete_set(D, supersets_wanted, analysis.conflict(D.get_size()));
+            }
             return 1;
         }
         
+        BoundAudit::Scope audit_scope(audit, nodes_visited);
+        if (audit_scope.sample())
+            audit_scope.measure(*dom_inst, D, fixed, mdd_stack->min_vertices_needed());
+        
         int bound_result = evaluate_bounds(G);
-        if (bound_result != 1)
+        if (bound_result != 1){
+            record_failure(branch_vertex);
+            if (analysis.is_enabled())
+                explain_bound(G, analysis.conflict(D.get_size()));
             return bound_result;
+        }
         
-        VertIndex i = choose_next_vertex(G);
+        ActivityScope activity_scope(activity);
+        VertIndex i = activity_enabled? choose_active_vertex(G) : choose_next_vertex(G);
         if (i == Graph::INVALID_VERTEX)
             assert(0);
         //TODO remove
@@ -439,19 +572,46 @@ private:
         VertIndex neighbour_array[i_deg+1];
         int neighbour_count = 0;
         rank_neighbours(G,i,neighbour_array,neighbour_count);
-    
+        if (neighbour_count == 0)
+            record_failure(i);
+        VertIndex parent_branch_vertex = branch_vertex;
+        branch_vertex = i;
         
         int fixed_list[i_deg+1]; //Standard C, but not standard C++
         int num_fixed = 0;
         
+        //The explanation of each branch is left one level down
+        int depth = D.get_size();
+        ConflictSet* node_conflict = analysis.is_enabled()? &analysis.conflict(depth) : nullptr;
+        ConflictSet* branch_conflict = analysis.is_enabled()? &analysis.conflict(depth+1) : nullptr;
+        if (analysis.is_enabled())
+            node_conflict->clear();
+        bool explained_by_branch = false;
+        
         for(VertIndex j: array_range(neighbour_array,neighbour_count)){
             bool force_stop = add_vertex_to_set<check_resmod_depth>(G,j,fixed_list,num_fixed);
+            if (analysis.is_enabled() && analysis.branch_failed(D, fixed, *node_conflict, *branch_conflict, fixed_list, num_fixed, neighbour_count, explained_by_branch))
+                break;
             if (FORCE_STOP_ON_TRAPPED_VERTEX && force_stop){
+                if (analysis.is_enabled()){
+                    analysis.explain_forced_stop(G, j, [this](VertIndex u){ return !covered[u] && CandidateNeighbours[u].get_size() == 0; }, *branch_conflict);
+                    explained_by_branch = analysis.absorb(*node_conflict, *branch_conflict, fixed_list, num_fixed);
+                }
                 break;
             }	
-            if (RECHECK_BOUNDS_IN_LOOP && evaluate_bounds(G) != 1)
+            if (RECHECK_BOUNDS_IN_LOOP && evaluate_bounds(G) != 1){
+                record_failure(branch_vertex);
+                if (analysis.is_enabled()){
+                    //The bound also holds in each of the remaining branches
+                    explain_bound(G, *branch_conflict);
+                    explained_by_branch = analysis.absorb(*node_conflict, *branch_conflict, fixed_list, num_fixed);
+                }
                 break;
+            }
         }
+        if (analysis.is_enabled())
+            analysis.finish_node(G, i, fixed, *node_conflict, fixed_list, num_fixed, explained_by_branch);
+        branch_vertex = parent_branch_vertex;
         
         
         for(int q = num_fixed - 1; q >= 0; q--){
@@ -494,5 +654,17 @@ REGISTER_SOLVER( MDD_maxMDD_desc_all, "MDD_maxMDD_desc_all", "MDD_maxMDD_desc_al
 
 
 
-REGISTER_SOLVER_ALIAS( MDD_minCD_desc, MDD_basic, "MDD", "MDD Bounding Solver (optimization)");
-REGISTER_SOLVER_ALIAS( MDD_minCD_desc_all, MDD_basic_all, "MDD_all", "MDD Bounding Solver (generation)");
\ No newline at end of file
+namespace{
+    //MDD with its policy chosen at runtime (the default is MDD_minCD_desc)
+    template<bool GENERATE_ALL>
+    class MDDPolicySolver: public PolicyDispatchSolver{
+    public:
+        MDDPolicySolver(): PolicyDispatchSolver( {"minMDD","maxMDD","minCD","maxCD"},
+            PolicyTable<BBTMDDSolverVariant,GENERATE_ALL,4>::constructors.data(),
+            {CHOOSE_VERTEX_MIN_CD,RANK_NEIGHBOURS_DESCENDING,false,true} ) {}
+    };
+    typedef MDDPolicySolver<false> MDD_policy;
+    typedef MDDPolicySolver<true> MDD_policy_all;
+}
+REGISTER_SOLVER( MDD_policy, "MDD", "MDD Bounding Solver (optimization). Policies: -choose minMDD/maxMDD/minCD/maxCD, -rank asc/desc, -force_stop, -norecheck");
+REGISTER_SOLVER( MDD_policy_all, "MDD_all", "MDD Bounding Solver (generation). Policies: -choose minMDD/maxMDD/minCD/maxCD, -rank asc/desc, -force_stop, -norecheck");
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include "unidom_arrayutil.hpp"
 #include "vertex_set.hpp"
 #include "bbt_degreepq.hpp"
+#include "bbt_worker_team.hpp"
 
 
 class MDDStack{
@@ -40,6 +41,14 @@ public:
         return max_mdd;
     }
     
+    //Split the recomputation of MDD values across the given team whenever at least
+    //threshold vertices need it (the results are applied in the same order as before,
+    //so the search is unchanged)
+    void set_team(WorkerTeam* team, int threshold){
+        this->team = team;
+        team_threshold = threshold;
+    }
+    
     VertIndex get_max_mdd_vertex(){
         VertIndex result = Graph::INVALID_VERTEX;
         for(VertIndex v: UndominatedSet){
@@ -85,10 +94,15 @@ public:
         //as far away as four steps from v, so there's really no more convenient way
         //to do this (since the uncovered set is likely to be much smaller than
         //the set of vertices up to four steps away from v)
+        bool split = use_team(UndominatedSet.get_size());
+        if (split)
+            recompute_in_team(UndominatedSet.begin(), UndominatedSet.get_size(), false);
+        int i = 0;
         for(VertIndex u: UndominatedSet){
             int old_mdd = get_mdd(u);
             assert(old_mdd != INVALID_MDD);
-            int new_mdd = recompute_mdd(u);
+            int new_mdd = split? recomputed[i] : recompute_mdd(u);
+            i++;
             if (old_mdd == new_mdd)
                 continue;
             assert(new_mdd < old_mdd);
@@ -129,11 +143,16 @@ public:
         //The function should be called just after the vertex v has been marked as fixed (i.e. removed as a candidate).
         StackRow& row = new_row(v);
         
-        for(VertIndex u: G[v].neighbours()){
+        Graph::neighbour_list& neighbours = G[v].neighbours();
+        bool split = use_team(neighbours.size());
+        if (split)
+            recompute_in_team(neighbours.data(), neighbours.size(), true);
+        for(int i = 0; i < (int)neighbours.size(); i++){
+            VertIndex u = neighbours[i];
             if (!UndominatedSet.contains(u))
                 continue;
             int old_mdd = mdd_values[u];
-            int new_mdd = recompute_mdd(u);
+            int new_mdd = split? recomputed[i] : recompute_mdd(u);
             if (new_mdd != old_mdd){
                 assert(new_mdd < old_mdd);
                 row.new_entry(u,old_mdd);
@@ -191,17 +210,16 @@ public:
              std::vector<VertexSet>& CandidateNeighbours, 
              VertexSet& undominated_set,
              DegreePQLight& undominated_dpq):
-        G(g), CandidateNeighboursArray(&CandidateNeighbours), UndominatedSet(undominated_set), UndominatedDPQ(&undominated_dpq) {
+        G(g), CandidateNeighboursArray(&CandidateNeighbours), UndominatedSet(undominated_set), UndominatedDPQ(&undominated_dpq),
+        team(nullptr), team_threshold(0) {
         n = G.n();
         
         stack_size = 0;
         for (auto& row: stack){
             row.size = 0;
             row.dominator = Graph::INVALID_VERTEX;
-            for(auto& entry: row.entries){
-                entry.vertex = Graph::INVALID_VERTEX;
-                entry.old_mdd = -1;
-            }
+            for(auto& entry: row.entries)
+                entry = StackEntry{};
         }
         
         mdd_values.fill(-1);
@@ -238,8 +256,8 @@ protected:
     
     int stack_size;
     struct StackEntry{
-        VertIndex vertex;
-        int old_mdd;
+        StoredVertIndex vertex;
+        StoredVertCount old_mdd;
     };
     struct StackRow{
     public:
@@ -269,6 +287,24 @@ protected:
     
     int max_mdd;
     
+    WorkerTeam* team;
+    int team_threshold;
+    std::array<int, unidom::MAX_VERTS> recomputed; //MDD values computed by the team
+    
+    bool use_team(int count){
+        return team && count >= team_threshold;
+    }
+    //Fill recomputed[i] with the MDD of vertices[i] for each i < count (only for the
+    //undominated vertices if skip_dominated is set)
+    void recompute_in_team(const StoredVertIndex* vertices, int count, bool skip_dominated){
+        auto job = [&](int begin, int end){
+            for(int i = begin; i < end; i++)
+                if (!skip_dominated || UndominatedSet.contains(vertices[i]))
+                    recomputed[i] = recompute_mdd(vertices[i]);
+        };
+        team->run(count, job);
+    }
+    
     
     StackRow& new_row(VertIndex dominator){
         StackRow& result = stack[stack_size++];
@@ -0,0 +1,460 @@
+/*  bbt_nogoods.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_NOGOODS_H
+#define BBT_NOGOODS_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "unidom_common.hpp"
+
+//Conflict analysis for the DD and MDD solvers (-nogoods). A decision of the search either
+//puts a vertex v in the set (the literal "v in") or excludes it after its branch has been
+//searched (the literal "v out"). A nogood is a set of literals which cannot all hold in a
+//set better than the best set found so far (or, when generating, in any set within the
+//size bounds). Nogoods stay valid as the best set improves, but not across the separate
+//searches of -deepen, so the database is cleared at the start of each search.
+//
+//Only literals which are true in the current search node are ever stored in a
+//ConflictSet, so it is enough to store the vertices (the literal is "v in" exactly
+//when v is in the current set).
+class ConflictSet{
+public:
+    void clear(){
+        words.fill(0);
+        depends_on_all = false;
+    }
+    //Used for failures which cannot be explained (e.g. the node limit), so the search
+    //never jumps over them.
+    void set_all(){
+        depends_on_all = true;
+    }
+    bool is_all(){
+        return depends_on_all;
+    }
+    void add(VertIndex v){
+        words[v/64] |= BitWord(1) << (v%64);
+    }
+    void remove(VertIndex v){
+        words[v/64] &= ~(BitWord(1) << (v%64));
+    }
+    bool contains(VertIndex v){
+        return (words[v/64] >> (v%64)) & 1;
+    }
+    void merge(ConflictSet& other){
+        depends_on_all |= other.depends_on_all;
+        for(int w = 0; w < NUM_WORDS; w++)
+            words[w] |= other.words[w];
+    }
+    int size(){
+        int count = 0;
+        for(BitWord word: words)
+            count += __builtin_popcountll(word);
+        return count;
+    }
+    template<typename VertexFunction>
+    void for_each(VertexFunction f){
+        for(int w = 0; w < NUM_WORDS; w++)
+            for(BitWord word = words[w]; word != 0; word &= word-1)
+                f((VertIndex)(64*w + __builtin_ctzll(word)));
+    }
+
+private:
+    typedef std::uint64_t BitWord;
+    static const int NUM_WORDS = (unidom::MAX_VERTS+63)/64;
+    std::array<BitWord, NUM_WORDS> words;
+    bool depends_on_all;
+};
+
+
+//A bounded database of nogoods, each of which watches one of its literals. A nogood is
+//stored when one of its literals has just become false (the "in" literal of the branch
+//which failed), and that literal is watched. When a watched literal becomes true, the
+//nogood moves its watch to another literal which is not true, and if there is none, every
+//literal holds and the current node can be pruned. Since the search backtracks right
+//after that, a watch never has to move when literals become false again.
+//Nogoods with more than max_length literals are not stored, and once the database is
+//full, the oldest nogood is replaced.
+class NogoodDatabase{
+public:
+    NogoodDatabase(): capacity(0), max_length(0) {}
+
+    static int in_literal(VertIndex v){
+        return 2*v+1;
+    }
+    static int out_literal(VertIndex v){
+        return 2*v;
+    }
+
+    //Allocates the database (call before the search, which does not allocate)
+    void reset(int num_verts, int capacity, int max_length){
+        this->capacity = capacity;
+        this->max_length = max_length;
+        literals.assign((std::size_t)capacity*max_length, 0);
+        length.assign(capacity, 0);
+        watch.assign(capacity, 0);
+        next_watcher.assign(capacity, NONE);
+        prev_watcher.assign(capacity, NONE);
+        first_watcher.assign(2*num_verts, NONE);
+        next_slot = 0;
+        num_learned = num_pruned = 0;
+    }
+    void clear(){
+        for(int g = 0; g < capacity; g++)
+            length[g] = 0;
+        for(int& first: first_watcher)
+            first = NONE;
+        next_slot = 0;
+    }
+
+    //Stores the conflict as a nogood watching "watched in", which must be false while
+    //the other literals are true (is_in(v) gives the sign of each other literal).
+    template<typename InFunction>
+    void learn(ConflictSet& conflict, VertIndex watched, InFunction is_in){
+        int conflict_size = conflict.size();
+        if (capacity == 0 || conflict_size > max_length)
+            return;
+        int g = next_slot;
+        next_slot = (next_slot+1)%capacity;
+        if (length[g] > 0)
+            unlink(g);
+        int* nogood = literals.data() + (std::size_t)g*max_length;
+        length[g] = 0;
+        conflict.for_each([&](VertIndex v){
+            if (v == watched){
+                watch[g] = length[g];
+                nogood[length[g]++] = in_literal(v);
+            }else{
+                nogood[length[g]++] = is_in(v)? in_literal(v) : out_literal(v);
+            }
+        });
+        link(g);
+        num_learned++;
+    }
+
+    //Call when the given literal has just become true. Returns a nogood which now holds
+    //completely (or NONE), after moving the watches of the others.
+    template<typename TrueFunction>
+    int find_violated(int literal, TrueFunction is_true){
+        int g = first_watcher[literal];
+        while(g != NONE){
+            int next = next_watcher[g];
+            int* nogood = literals.data() + (std::size_t)g*max_length;
+            int k = 0;
+            while(k < length[g] && (k == watch[g] || is_true(nogood[k])))
+                k++;
+            if (k == length[g]){
+                num_pruned++;
+                return g;
+            }
+            unlink(g);
+            watch[g] = k;
+            link(g);
+            g = next;
+        }
+        return NONE;
+    }
+    //The vertices of the literals of nogood g
+    void get_conflict(int g, ConflictSet& conflict){
+        conflict.clear();
+        int* nogood = literals.data() + (std::size_t)g*max_length;
+        for(int k = 0; k < length[g]; k++)
+            conflict.add(nogood[k]/2);
+    }
+
+    unsigned long long learned_count(){
+        return num_learned;
+    }
+    unsigned long long pruned_count(){
+        return num_pruned;
+    }
+
+    static constexpr int NONE = -1;
+
+private:
+    int capacity, max_length;
+    std::vector<int> literals; //Nogood g has literals[g*max_length] to literals[g*max_length+length[g]-1]
+    std::vector<int> length; //0 for unused slots
+    std::vector<int> watch; //Index of the watched literal of each nogood
+    std::vector<int> next_watcher, prev_watcher; //Doubly linked list of the nogoods watching each literal
+    std::vector<int> first_watcher;
+    int next_slot;
+    unsigned long long num_learned, num_pruned;
+
+    int watched_literal(int g){
+        return literals[(std::size_t)g*max_length + watch[g]];
+    }
+    void link(int g){
+        int l = watched_literal(g);
+        prev_watcher[g] = NONE;
+        next_watcher[g] = first_watcher[l];
+        if (first_watcher[l] != NONE)
+            prev_watcher[first_watcher[l]] = g;
+        first_watcher[l] = g;
+    }
+    void unlink(int g){
+        if (prev_watcher[g] != NONE)
+            next_watcher[prev_watcher[g]] = next_watcher[g];
+        else
+            first_watcher[watched_literal(g)] = next_watcher[g];
+        if (next_watcher[g] != NONE)
+            prev_watcher[next_watcher[g]] = prev_watcher[g];
+    }
+};
+
+//The conflict analysis of a search (see ConflictAnalysis) for the DD and MDD solvers,
+//which share their search: each node branches on the candidates which can dominate an
+//undominated vertex i, and each candidate stays excluded once its branch has returned.
+//Each failed node leaves the decisions which explain its failure in conflict(depth), and
+//each branch leaves its explanation one level down. A branch whose explanation involves
+//none of the decisions of its node explains the whole node, so the remaining branches
+//are skipped (a backjump), and the explanations of failed branches are stored as
+//nogoods, which are checked whenever a vertex is added or excluded.
+class ConflictAnalysis{
+public:
+    ConflictAnalysis(): enabled(false), nogood_limit(DEFAULT_LIMIT), nogood_length(DEFAULT_LENGTH) {}
+
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-nogoods")
+            enabled = true;
+        else if (arg == "-nogood_limit")
+            nogood_limit = parser.get_next_unsigned_int();
+        else if (arg == "-nogood_length")
+            nogood_length = parser.get_next_unsigned_int();
+        else
+            return false;
+        return true;
+    }
+    bool is_enabled(){
+        return enabled;
+    }
+
+    //Called before the search of each instance (the search itself does not allocate)
+    void start(unidom::DominationInstance& inst){
+        if (!enabled)
+            return;
+        int n = inst.G.n();
+        //The forced vertices are not decisions of the search, so nogoods leave them out
+        permanent.fill(0);
+        for(VertIndex v: inst.force_in)
+            permanent[v] = 1;
+        for(VertIndex v: inst.force_out)
+            permanent[v] = 1;
+        nogoods.reset(n, nogood_limit, nogood_length);
+        conflicts.resize(n+2);
+        reach_mark.fill(0);
+        current_reach_mark = 0;
+        num_backjumps = 0;
+    }
+    //Called at the start of each search of -deepen
+    void start_search(){
+        if (enabled)
+            nogoods.clear();
+    }
+    void finish(bool verbose){
+        if (enabled && verbose)
+            unidom::log << "Nogoods: " << nogoods.learned_count() << " learned, " << nogoods.pruned_count() << " branches pruned, " << num_backjumps << " backjumps" << std::endl;
+    }
+
+    ConflictSet& conflict(int depth){
+        return conflicts[depth];
+    }
+
+    //Call when a literal has just become true (as j is added to D, or after its branch
+    //has returned). If it completes a nogood, stores it in conflict and returns true.
+    template<typename FixedArray>
+    bool prune(int literal, VertexSet& D, const FixedArray& fixed, ConflictSet& conflict){
+        int g = nogoods.find_violated(literal, [&](int l){
+            VertIndex v = l/2;
+            if (l == NogoodDatabase::in_literal(v))
+                return D.contains(v);
+            return fixed[v] && !D.contains(v);
+        });
+        if (g == NogoodDatabase::NONE)
+            return false;
+        nogoods.get_conflict(g, conflict);
+        return true;
+    }
+
+    //A complete set: no set containing D is better, unless the supersets of D could still
+    //be output (supersets_wanted)
+    void explain_complete_set(VertexSet& D, bool supersets_wanted, ConflictSet& conflict){
+        conflict.clear();
+        if (supersets_wanted){
+            conflict.set_all();
+            return;
+        }
+        for(VertIndex v: D)
+            if (!permanent[v])
+                conflict.add(v);
+    }
+    //A bound failure, for a bound on the number of candidates needed to dominate the
+    //undominated vertices U: it holds for any set containing D in which the excluded
+    //neighbours of U stay excluded. A vertex d of D can also be left out of the
+    //explanation if it has a private neighbour p (dominated by no other vertex of D) which
+    //shares no possible dominator with U or the other such neighbours: a set without d
+    //still needs a separate vertex to dominate p, so it is no smaller. The most recent
+    //decisions are tried first, since leaving them out allows the longest backjumps.
+    template<typename CoveredArray, typename FixedArray>
+    void explain_bound(Graph& G, VertexSet& D, const CoveredArray& covered, const FixedArray& fixed, ConflictSet& conflict){
+        conflict.clear();
+        current_reach_mark++;
+        for(VertIndex u = 0; u < G.n(); u++){
+            if (covered[u])
+                continue;
+            for(VertIndex w: G[u].neighbours()){
+                reach_mark[w] = current_reach_mark;
+                if (fixed[w] && !permanent[w])
+                    conflict.add(w);
+            }
+        }
+        for(const StoredVertIndex* d = D.end(); d != D.begin(); ){
+            VertIndex v = *--d;
+            if (permanent[v])
+                continue;
+            VertIndex pivot = Graph::INVALID_VERTEX;
+            for(VertIndex p: G[v].neighbours()){
+                if (covered[p] != 1)
+                    continue;
+                bool separate = true;
+                for(VertIndex x: G[p].neighbours())
+                    if (reach_mark[x] == current_reach_mark){
+                        separate = false;
+                        break;
+                    }
+                if (separate){
+                    pivot = p;
+                    break;
+                }
+            }
+            if (pivot == Graph::INVALID_VERTEX){
+                conflict.add(v);
+                continue;
+            }
+            for(VertIndex x: G[pivot].neighbours())
+                reach_mark[x] = current_reach_mark;
+        }
+    }
+    //An undominated vertex u with no candidates left: its neighbours are all excluded
+    void explain_trapped_vertex(Graph& G, VertIndex u, ConflictSet& conflict){
+        conflict.clear();
+        for(VertIndex w: G[u].neighbours())
+            if (!permanent[w])
+                conflict.add(w);
+    }
+    //A failure which depends on every vertex fixed so far (e.g. on the number of
+    //candidates left)
+    template<typename FixedArray>
+    void explain_fixed(int n, const FixedArray& fixed, ConflictSet& conflict){
+        conflict.clear();
+        for(VertIndex v = 0; v < n; v++)
+            if (fixed[v] && !permanent[v])
+                conflict.add(v);
+    }
+    //After a forced stop (see the FORCE_STOP_ON_TRAPPED_VERTEX policy), which is explained
+    //by a vertex near j which has no candidates left (trapped(u) is true), if there is one
+    template<typename TrappedFunction>
+    void explain_forced_stop(Graph& G, VertIndex j, TrappedFunction trapped, ConflictSet& conflict){
+        conflict.set_all();
+        for(VertIndex u: G[j].neighbours())
+            if (trapped(u)){
+                explain_trapped_vertex(G, u, conflict);
+                return;
+            }
+    }
+
+    //Adds the explanation of a failed branch (or of all of the remaining branches) to the
+    //conflict of its node, given the vertices the node has added so far. Returns true if
+    //the explanation involves none of them, in which case it explains the whole node by
+    //itself.
+    bool absorb(ConflictSet& node_conflict, ConflictSet& branch_conflict, int* fixed_list, int num_fixed){
+        if (!branch_conflict.is_all()){
+            bool independent = true;
+            for(int q = 0; q < num_fixed; q++)
+                if (branch_conflict.contains(fixed_list[q]))
+                    independent = false;
+            if (independent){
+                node_conflict = branch_conflict;
+                return true;
+            }
+        }
+        node_conflict.merge(branch_conflict);
+        return false;
+    }
+    //Called when the branch which added j (the last vertex of fixed_list) has returned and
+    //j is excluded. Returns true if the remaining branches of the node can be skipped: if
+    //the explanation of the branch explains the whole node (explained is then set), if it
+    //does not depend on j being in the set (so it also holds in the remaining branches),
+    //or if excluding j completes a nogood. Otherwise, the explanation is learned.
+    template<typename FixedArray>
+    bool branch_failed(VertexSet& D, const FixedArray& fixed, ConflictSet& node_conflict, ConflictSet& branch_conflict, int* fixed_list, int num_fixed, int branch_count, bool& explained){
+        VertIndex j = fixed_list[num_fixed-1];
+        explained = absorb(node_conflict, branch_conflict, fixed_list, num_fixed);
+        if (explained){
+            if (num_fixed < branch_count)
+                num_backjumps++;
+            return true;
+        }
+        if (!branch_conflict.is_all()){
+            if (!branch_conflict.contains(j)){
+                if (num_fixed < branch_count)
+                    num_backjumps++;
+                return true;
+            }
+            nogoods.learn(branch_conflict, j, [&](VertIndex v){ return D.contains(v); });
+        }
+        if (prune(NogoodDatabase::out_literal(j), D, fixed, branch_conflict)){
+            explained = absorb(node_conflict, branch_conflict, fixed_list, num_fixed);
+            return true;
+        }
+        return false;
+    }
+    //Called before the node which branched on the candidates of i returns. Unless one
+    //branch explained it by itself, every branch failed, so the explanation is those of
+    //the branches, without the decisions of the node, plus the neighbours of i which were
+    //excluded before the node.
+    template<typename FixedArray>
+    void finish_node(Graph& G, VertIndex i, const FixedArray& fixed, ConflictSet& node_conflict, int* fixed_list, int num_fixed, bool explained){
+        if (explained || node_conflict.is_all())
+            return;
+        for(VertIndex w: G[i].neighbours())
+            if (fixed[w] && !permanent[w])
+                node_conflict.add(w);
+        for(int q = 0; q < num_fixed; q++)
+            node_conflict.remove(fixed_list[q]);
+    }
+
+private:
+    static const unsigned int DEFAULT_LIMIT = 10000;
+    static const unsigned int DEFAULT_LENGTH = 16;
+
+    bool enabled;
+    unsigned int nogood_limit; //Number of nogoods stored
+    unsigned int nogood_length; //Longest nogood stored
+    NogoodDatabase nogoods;
+    std::vector<ConflictSet> conflicts; //Indexed by depth
+    std::array<char,unidom::MAX_VERTS> permanent; //The force_in and force_out vertices
+    std::array<unsigned int,unidom::MAX_VERTS> reach_mark; //Used by explain_bound
+    unsigned int current_reach_mark;
+    unsigned long long num_backjumps;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*  bbt_policy_dispatch.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_POLICY_DISPATCH_H
+#define BBT_POLICY_DISPATCH_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include "unidom_common.hpp"
+
+//Runtime selection of the policy template parameters of the DD and MDD solvers
+//(CHOOSE_VERTEX_RULE, RANK_NEIGHBOURS_RULE, FORCE_STOP_ON_TRAPPED_VERTEX and
+//RECHECK_BOUNDS_IN_LOOP). Every combination is instantiated at compile time (so each
+//still has its own specialized search loop), and a table of constructors indexed by
+//the policy picks one when the arguments are parsed.
+
+struct SolverPolicy{
+    unsigned int choose_rule;
+    unsigned int rank_rule;
+    bool force_stop;
+    bool recheck;
+    unsigned int index() const{
+        return ((choose_rule*2 + rank_rule)*2 + force_stop)*2 + recheck;
+    }
+};
+
+typedef unidom::SolverPtr (*PolicyVariantConstructor)(std::string name);
+
+//Variant classes are not registered components, so they get their name (used in
+//log messages) from the dispatcher.
+template<typename Variant>
+class DispatchedVariant: public Variant{
+public:
+    DispatchedVariant(std::string name): variant_name(name) {}
+    std::string name(){
+        return variant_name;
+    }
+    std::string description(){
+        return "";
+    }
+private:
+    std::string variant_name;
+};
+
+template< template<unsigned int, unsigned int, bool, bool, bool> class Variant, bool GENERATE_ALL, unsigned int NUM_CHOOSE_RULES >
+struct PolicyTable{
+    static const unsigned int size = NUM_CHOOSE_RULES*8;
+
+    template<std::size_t I>
+    static unidom::SolverPtr construct(std::string name){
+        return std::make_shared< DispatchedVariant< Variant<I/8, (I/4)%2, (I/2)%2 == 1, I%2 == 1, GENERATE_ALL> > >(name);
+    }
+    template<std::size_t... I>
+    static constexpr std::array<PolicyVariantConstructor, sizeof...(I)> build(std::index_sequence<I...>){
+        return {{ &construct<I>... }};
+    }
+    static constexpr std::array<PolicyVariantConstructor, size> constructors = build(std::make_index_sequence<size>());
+};
+
+//Passes tokens through from another tokenizer, keeping a copy of each one
+//(so that arguments accepted by one variant can be replayed to another).
+class RecordingArgumentTokenizer: public unidom::ArgumentTokenizer{
+public:
+    RecordingArgumentTokenizer(unidom::ArgumentTokenizer& parser): inner(parser) {}
+    std::string get_next_string(){
+        std::string s = inner.get_next_string();
+        recorded.push_back(s);
+        return s;
+    }
+    int get_next_int(){
+        int x = inner.get_next_int();
+        recorded.push_back(std::to_string(x));
+        return x;
+    }
+    unsigned int get_next_unsigned_int(){
+        unsigned int x = inner.get_next_unsigned_int();
+        recorded.push_back(std::to_string(x));
+        return x;
+    }
+    double get_next_double(){
+        double x = inner.get_next_double();
+        std::ostringstream s;
+        s.precision(17);
+        s << x;
+        recorded.push_back(s.str());
+        return x;
+    }
+    bool has_next(){
+        return inner.has_next();
+    }
+    std::vector<std::string> recorded;
+private:
+    unidom::ArgumentTokenizer& inner;
+};
+
+//Selects a policy with -choose <rule>, -rank asc/desc, -force_stop/-noforce_stop and
+//-recheck/-norecheck, and passes every other argument to the selected variant.
+class PolicyDispatchSolver: public unidom::Solver{
+public:
+    PolicyDispatchSolver(std::vector<std::string> choose_rule_names, const PolicyVariantConstructor* constructors, SolverPolicy default_policy):
+        choose_rule_names(choose_rule_names), constructors(constructors), policy(default_policy) {}
+
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-choose"){
+            std::string rule = parser.get_next_string();
+            unsigned int i = 0;
+            while(i < choose_rule_names.size() && choose_rule_names[i] != rule)
+                i++;
+            if (i == choose_rule_names.size()){
+                std::string valid_rules;
+                for(auto& r: choose_rule_names)
+                    valid_rules += (valid_rules == "")? r : ", "+r;
+                throw unidom::ConfigurableError("Unknown vertex choice rule \""+rule+"\" for solver "+name()+" (use "+valid_rules+").");
+            }
+            policy.choose_rule = i;
+        }else if (arg == "-rank"){
+            std::string rule = parser.get_next_string();
+            if (rule == "asc")
+                policy.rank_rule = 0;
+            else if (rule == "desc")
+                policy.rank_rule = 1;
+            else
+                throw unidom::ConfigurableError("Unknown neighbour ranking \""+rule+"\" (use asc or desc).");
+        }else if (arg == "-force_stop")
+            policy.force_stop = true;
+        else if (arg == "-noforce_stop")
+            policy.force_stop = false;
+        else if (arg == "-recheck")
+            policy.recheck = true;
+        else if (arg == "-norecheck")
+            policy.recheck = false;
+        else{
+            RecordingArgumentTokenizer recorder(parser);
+            if (!get_variant().accept_argument(arg, recorder))
+                return false;
+            variant_arguments.push_back(arg);
+            variant_arguments.insert(variant_arguments.end(), recorder.recorded.begin(), recorder.recorded.end());
+            return true;
+        }
+        variant = nullptr; //Rebuilt (with the arguments so far) when next needed
+        return true;
+    }
+
+    void set_solver_context(unidom::SolverContext& c){
+        unidom::Solver::set_solver_context(c);
+        solver_context_set = true;
+        if (variant)
+            variant->set_solver_context(c);
+    }
+
+    void solve(unidom::DominationInstance& inst, unidom::OutputProxy& output_proxy){
+        get_variant().solve(inst, output_proxy);
+    }
+    bool generates_all(){
+        return get_variant().generates_all();
+    }
+    unsigned long long search_node_count(){
+        return get_variant().search_node_count();
+    }
+    bool result_is_optimal(){
+        return get_variant().result_is_optimal();
+    }
+    bool result_is_cacheable(){
+        return get_variant().result_is_cacheable();
+    }
+private:
+    std::vector<std::string> choose_rule_names;
+    const PolicyVariantConstructor* constructors;
+    SolverPolicy policy;
+    unidom::SolverPtr variant;
+    std::vector<std::string> variant_arguments;
+    bool solver_context_set = false;
+
+    unidom::Solver& get_variant(){
+        if (!variant){
+            variant = constructors[policy.index()](name());
+            unidom::ListArgumentTokenizer tokenizer(variant_arguments);
+            if (!variant->parse_arguments(tokenizer))
+                throw unidom::ConfigurableError("Invalid arguments for solver "+name()+".");
+            if (solver_context_set)
+                variant->set_solver_context(get_solver_context());
+        }
+        return *variant;
+    }
+};
+
+#endif
@@ -0,0 +1,125 @@
+/*  bbt_worker_team.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BBT_WORKER_TEAM_H
+#define BBT_WORKER_TEAM_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//A barrier for a fixed number of threads. The waits between the jobs of a WorkerTeam
+//are short while the search is in large nodes, so a waiting thread spins for a while
+//first, and then sleeps (on a futex, through std::atomic::wait) until the last thread
+//arrives, so that a team waiting through many small nodes does not keep its cores busy.
+class SpinBarrier{
+public:
+    SpinBarrier(int count): count(count), waiting(0), phase(0) {}
+
+    void wait(){
+        unsigned int my_phase = phase.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) == count-1){
+            waiting.store(0, std::memory_order_relaxed);
+            phase.fetch_add(1, std::memory_order_acq_rel);
+            phase.notify_all();
+            return;
+        }
+        for(int spins = 0; spins < SPINS_BEFORE_SLEEP; spins++)
+            if (phase.load(std::memory_order_acquire) != my_phase)
+                return;
+        while(phase.load(std::memory_order_acquire) == my_phase)
+            phase.wait(my_phase, std::memory_order_acquire);
+    }
+private:
+    static const int SPINS_BEFORE_SLEEP = 4000;
+    const int count;
+    std::atomic<int> waiting;
+    std::atomic<unsigned int> phase;
+};
+
+//A small team of threads for splitting the bulk work of a single search node (such as
+//recomputing the MDD of every undominated vertex) when the residual graph is large,
+//near the root of the search tree where the tree itself is too narrow to split.
+//run(count, f) calls f(begin, end) on one contiguous part of [0, count) for each member
+//of the team (the calling thread being member 0) and returns once all parts are done.
+//The other members wait for the next job at a SpinBarrier, so a job costs two barrier
+//crossings and no allocations. Members that wait longer than the spin budget sleep, so
+//the team only keeps its cores busy while jobs are arriving in quick succession.
+class WorkerTeam{
+public:
+    WorkerTeam(int size): size(size), start_barrier(size), finish_barrier(size), stopping(false),
+        job_count(0), job_context(nullptr), job_function(nullptr) {
+        for(int member = 1; member < size; member++)
+            threads.emplace_back([this, member](){
+                worker_loop(member);
+            });
+    }
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+    ~WorkerTeam(){
+        stopping = true;
+        start_barrier.wait();
+        for(auto& thread: threads)
+            thread.join();
+    }
+
+    int get_size(){
+        return size;
+    }
+
+    template<typename Function>
+    void run(int count, Function& f){
+        job_count = count;
+        job_context = (void*)&f;
+        job_function = [](void* context, int begin, int end){
+            (*(Function*)context)(begin, end);
+        };
+        start_barrier.wait();
+        run_part(0);
+        finish_barrier.wait();
+    }
+private:
+    const int size;
+    std::vector<std::thread> threads;
+    SpinBarrier start_barrier, finish_barrier;
+    bool stopping;
+
+    //The current job (written before start_barrier is crossed)
+    int job_count;
+    void* job_context;
+    void (*job_function)(void*, int, int);
+
+    void worker_loop(int member){
+        while(true){
+            start_barrier.wait();
+            if (stopping)
+                return;
+            run_part(member);
+            finish_barrier.wait();
+        }
+    }
+    void run_part(int member){
+        int begin = (long long)job_count*member/size;
+        int end = (long long)job_count*(member+1)/size;
+        if (begin < end)
+            job_function(job_context, begin, end);
+    }
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*  clique_cover_filters.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "unidom_common.hpp"
+#include "graph_util.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::ArgumentTokenizer;
+using unidom::DominationInstance;
+using unidom::PreprocessFilter;
+
+//Attaches a greedily constructed edge clique cover to the instance (for graphs
+//whose input source does not supply one).
+class CliqueCoverFilter: public PreprocessFilter{
+public:
+    CliqueCoverFilter(): replace_existing(false) {}
+    bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
+        if (arg == "-replace"){
+            replace_existing = true;
+            return true;
+        }
+        return PreprocessFilter::accept_argument(arg,parser);
+    }
+    void process(DominationInstance& inst){
+        if (inst.clique_cover.size() > 0 && !replace_existing)
+            return;
+        inst.clique_cover = greedy_clique_cover(inst.G);
+    }
+private:
+    bool replace_existing;
+};
+
+REGISTER_PREPROCESS_FILTER( CliqueCoverFilter, "clique_cover", "Compute an edge clique cover greedily if the input source did not provide one (use -replace to discard a provided cover).");
@@ -0,0 +1,222 @@
+/*  component_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "unidom_common.hpp"
+#include "graph_util.hpp"
+#include "compound_solver.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+
+namespace{
+
+    //Solves each connected component of the graph separately with an optimizing
+    //base solver, then outputs the union of the minimum dominating sets of the
+    //components. Bishop graphs, for example, split into the two colour classes of
+    //the board. Any edge clique cover or incumbent set of the instance is passed on to
+    //the components.
+    class ComponentSolver: public CompoundSolverBase{
+    public:
+        ComponentSolver(): CompoundSolverBase("DD") {}
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            if (base_generates_all())
+                throw unidom::ConfigurableError("The components solver requires an optimizing base solver.");
+            Graph& G = inst.G;
+            int n = G.n();
+            vector< vector<VertIndex> > components = connected_components(G);
+            unidom::log << "Split into " << components.size() << " components" << std::endl;
+
+            unidom::SolverPtr solver = spawn_base_solver(vector<string>());
+            if (components.size() <= 1 && n > MAX_DIRECT_VERTS){
+                solver->solve(inst,output_proxy);
+                all_optimal = solver->result_is_optimal();
+                return;
+            }
+
+            vector<int> component_of(n);
+            for(unsigned int i = 0; i < components.size(); i++)
+                for(VertIndex v: components[i])
+                    component_of[v] = i;
+
+            VertexSet combined_set;
+            combined_set.reset_empty();
+            bool found_all = true;
+            all_optimal = true;
+            for(unsigned int i = 0; i < components.size(); i++){
+                vector<VertIndex>& vertices = components[i];
+                DominationInstance component_inst = component_instance(inst, vertices, component_of, i);
+                VertexSet component_set;
+                bool found;
+                if ((int)vertices.size() <= MAX_DIRECT_VERTS){
+                    found = solve_directly(component_inst, component_set);
+                }else{
+                    BestSetCaptureProxy capture;
+                    solver->solve(component_inst, capture);
+                    bool optimal = solver->result_is_optimal();
+                    found = capture.found;
+                    component_set = capture.best_set;
+                    //A complete search which found nothing may have missed a minimum with n-1
+                    //or n vertices (possible with force_out), so it is repeated directly
+                    if (!found && optimal)
+                        found = solve_directly(component_inst, component_set);
+                    all_optimal = all_optimal && optimal;
+                }
+                if (!found){
+                    unidom::log << "Component " << i << " (" << vertices.size() << " vertices): no dominating set" << std::endl;
+                    found_all = false;
+                    break;
+                }
+                unidom::log << "Component " << i << " (" << vertices.size() << " vertices): " << component_set.get_size() << std::endl;
+                for(VertIndex v: component_set)
+                    combined_set.add(vertices[v]);
+            }
+
+            output_proxy.initialize(inst);
+            if (found_all)
+                output_proxy.process_set(inst,combined_set);
+            output_proxy.finalize(inst);
+        }
+        
+        bool result_is_optimal(){
+            return all_optimal;
+        }
+        bool result_is_cacheable(){
+            return base_result_is_cacheable();
+        }
+    private:
+        bool all_optimal = false;
+
+        //The subgraph induced by component i, with the constraints, clique cover and
+        //incumbent of the instance restricted to it
+        DominationInstance component_instance(DominationInstance& inst, vector<VertIndex>& vertices, vector<int>& component_of, unsigned int i){
+            vector<VertIndex> new_index(inst.G.n(), (VertIndex)Graph::INVALID_VERTEX);
+            for(unsigned int j = 0; j < vertices.size(); j++)
+                new_index[vertices[j]] = j;
+
+            DominationInstance component_inst;
+            inst.G.induced_subgraph(vertices, component_inst.G);
+            component_inst.force_in.reset_empty();
+            component_inst.force_out.reset_empty();
+            for(VertIndex v: inst.force_in)
+                if (component_of[v] == (int)i)
+                    component_inst.force_in.add(new_index[v]);
+            for(VertIndex v: inst.force_out)
+                if (component_of[v] == (int)i)
+                    component_inst.force_out.add(new_index[v]);
+            //Every clique lies inside a single component
+            for(auto& clique: inst.clique_cover){
+                if (clique.size() == 0 || component_of[clique[0]] != (int)i)
+                    continue;
+                vector<VertIndex> mapped_clique;
+                for(VertIndex v: clique)
+                    mapped_clique.push_back(new_index[v]);
+                component_inst.clique_cover.push_back(mapped_clique);
+            }
+            //The part of an incumbent inside the component dominates the component
+            for(VertIndex v: inst.incumbent)
+                if (component_of[v] == (int)i)
+                    component_inst.incumbent.add(new_index[v]);
+            return component_inst;
+        }
+
+        //The base solvers only look for sets with fewer than n-1 vertices, so they find
+        //nothing on components with one or two vertices
+        static const int MAX_DIRECT_VERTS = 2;
+
+        //Exact search for the components above, branching on the ways to dominate the
+        //first undominated vertex, and pruned by a counting bound (the number of undominated
+        //vertices divided by the most that any one candidate could dominate)
+        bool solve_directly(DominationInstance& component_inst, VertexSet& result){
+            Graph& G = component_inst.G;
+            int n = G.n();
+            vector<int> dominators(n, 0);
+            VertexSet S;
+            S.reset_empty();
+            for(VertIndex v: component_inst.force_in)
+                add_directly(G, S, dominators, v);
+            //Every vertex which is not forced out is a dominating set, unless some vertex
+            //has its whole closed neighbourhood forced out
+            result.reset_empty();
+            for(VertIndex v = 0; v < n; v++)
+                if (!component_inst.force_out.contains(v))
+                    result.add(v);
+            for(VertIndex v = 0; v < n; v++){
+                bool dominated = result.contains(v);
+                for(VertIndex u: G[v].neighbours())
+                    dominated = dominated || result.contains(u);
+                if (!dominated)
+                    return false;
+            }
+            direct_search(component_inst, S, dominators, result);
+            return true;
+        }
+        void add_directly(Graph& G, VertexSet& S, vector<int>& dominators, VertIndex v){
+            S.add(v);
+            dominators[v]++;
+            for(VertIndex u: G[v].neighbours())
+                dominators[u]++;
+        }
+        void direct_search(DominationInstance& component_inst, VertexSet& S, vector<int>& dominators, VertexSet& best){
+            Graph& G = component_inst.G;
+            VertIndex u = std::find(dominators.begin(), dominators.end(), 0) - dominators.begin();
+            if (u == (VertIndex)dominators.size()){
+                best = S;
+                return;
+            }
+            int undominated = 0, max_gain = 0;
+            for(VertIndex v = 0; v < G.n(); v++){
+                undominated += (dominators[v] == 0);
+                if (component_inst.force_out.contains(v) || S.contains(v))
+                    continue;
+                int gain = (dominators[v] == 0);
+                for(VertIndex w: G[v].neighbours())
+                    gain += (w != v && dominators[w] == 0);
+                max_gain = std::max(max_gain, gain);
+            }
+            if (max_gain == 0 || S.get_size() + (undominated+max_gain-1)/max_gain >= best.get_size())
+                return;
+            auto try_vertex = [&](VertIndex w){
+                if (component_inst.force_out.contains(w) || S.contains(w))
+                    return;
+                add_directly(G, S, dominators, w);
+                direct_search(component_inst, S, dominators, best);
+                for(VertIndex x: G[w].neighbours())
+                    dominators[x]--;
+                dominators[w]--;
+                S.remove_pop(w);
+            };
+            try_vertex(u);
+            for(VertIndex w: G[u].neighbours())
+                if (w != u)
+                    try_vertex(w);
+        }
+    };
+
+}
+
+REGISTER_SOLVER( ComponentSolver, "components", "Solve each connected component of the graph separately with an optimizing base solver (-base NAME args...) and combine the results" );
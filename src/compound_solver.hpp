@@ -0,0 +1,112 @@
+/*  compound_solver.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMPOUND_SOLVER_H
+#define COMPOUND_SOLVER_H
+
+#include <string>
+#include <vector>
+#include "unidom_common.hpp"
+
+//Base class for solvers which delegate (part of) the search to other solvers.
+//The base solver is chosen with "-base <name>", and every argument after
+//the name is passed to the base solver, so "-base" must be the last
+//argument of the compound solver.
+class CompoundSolverBase: public unidom::Solver{
+public:
+    CompoundSolverBase(std::string default_base): base_solver_name(default_base) {}
+
+    bool parse_arguments(unidom::ArgumentTokenizer& parser){
+        while(parser.has_next()){
+            std::string arg = parser.get_next_string();
+            if (arg == "-base"){
+                base_solver_name = parser.get_next_string();
+                base_solver_arguments.clear();
+                while(parser.has_next())
+                    base_solver_arguments.push_back(parser.get_next_string());
+                //Spawn one instance now so that invalid base arguments are reported early
+                spawn_base_solver(std::vector<std::string>());
+            }else if (!accept_argument(arg, parser))
+                return false;
+        }
+        return true;
+    }
+
+    bool generates_all(){
+        return base_generates_all();
+    }
+
+protected:
+    //Create a new instance of the base solver with the arguments given after
+    //"-base <name>", followed by the provided extra arguments.
+    unidom::SolverPtr spawn_base_solver(std::vector<std::string> extra_arguments){
+        unidom::SolverPtr solver = unidom::spawn_solver(base_solver_name);
+        if (!solver)
+            throw unidom::ConfigurableError("Base solver \""+base_solver_name+"\" not found.");
+        std::vector<std::string> arguments = base_solver_arguments;
+        arguments.insert(arguments.end(), extra_arguments.begin(), extra_arguments.end());
+        unidom::ListArgumentTokenizer tokenizer(arguments);
+        if (!solver->parse_arguments(tokenizer))
+            throw unidom::ConfigurableError("Invalid arguments for base solver \""+base_solver_name+"\".");
+        if (solver_context_set)
+            solver->set_solver_context(get_solver_context());
+        return solver;
+    }
+
+    void set_solver_context(unidom::SolverContext& c){
+        unidom::Solver::set_solver_context(c);
+        solver_context_set = true;
+    }
+
+    bool base_generates_all(){
+        return spawn_base_solver(std::vector<std::string>())->generates_all();
+    }
+
+    bool base_result_is_cacheable(){
+        return spawn_base_solver(std::vector<std::string>())->result_is_cacheable();
+    }
+
+    std::string base_solver_name;
+    std::vector<std::string> base_solver_arguments;
+private:
+    bool solver_context_set = false;
+};
+
+//Keeps the smallest set produced by a (base) solver, without outputting anything.
+class BestSetCaptureProxy: public unidom::OutputProxy{
+public:
+    std::string name(){
+        return "best_set_capture";
+    }
+    std::string description(){
+        return "";
+    }
+    void initialize(unidom::DominationInstance& inst){
+        found = false;
+    }
+    void process_set(unidom::DominationInstance& inst, VertexSet& dominating_set){
+        if (!found || dominating_set.get_size() < best_set.get_size())
+            best_set = dominating_set;
+        found = true;
+    }
+    bool found = false;
+    VertexSet best_set;
+};
+
+#endif
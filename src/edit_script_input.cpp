@@ -0,0 +1,219 @@
+/*  edit_script_input.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "unidom_common.hpp"
+#include "graph_util.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::InputSource;
+using unidom::DominationInstance;
+
+namespace{
+
+    //Reads a graph in the basic_input format from standard input (as an undirected
+    //graph without loops), followed by a script of edits, one per line:
+    //  add_edge u v, remove_edge u v, add_vertex (numbered n), remove_vertex v
+    //  (later vertices are renumbered down by one)
+    //Each block of edits ending with "solve" (or the end of the input) produces the next
+    //instance: the initial graph with all edits so far applied. The best set found for
+    //the previous instance is carried over the edits and repaired (each undominated
+    //vertex is dominated by the vertex of its closed neighbourhood covering the most
+    //undominated vertices, then vertices which are no longer needed are dropped) to
+    //become the incumbent of the new instance. A lower bound hint is also derived from
+    //the previous result (when it was proven minimum): removing an edge never decreases
+    //the domination number, adding an edge or removing a vertex decreases it by at most
+    //one and adding an isolated vertex increases it by exactly one.
+    class EditScriptInputSource: public InputSource{
+    public:
+        EditScriptInputSource(): started(false) {}
+
+        bool read_next(DominationInstance& inst){
+            if (!started){
+                started = true;
+                Graph G;
+                if (!read_graph(std::cin,G))
+                    return false;
+                int n = G.n();
+                adjacency.assign(n, vector<VertIndex>());
+                for(VertIndex v = 0; v < n; v++)
+                    for(VertIndex u: G[v].neighbours())
+                        if (u != v && u >= 0 && u < n)
+                            add_edge(u,v);
+                build_instance(inst);
+                return true;
+            }
+
+            unidom::SolverContext& C = get_solver_context();
+            in_set.assign(adjacency.size(), 0);
+            for(VertIndex v: C.previous_result)
+                if (v >= 0 && v < (int)adjacency.size())
+                    in_set[v] = 1;
+            int lower_bound = C.previous_lower_bound;
+
+            bool any_edits = false;
+            string command;
+            while(std::cin >> command){
+                if (command == "solve"){
+                    any_edits = true;
+                    break;
+                }
+                any_edits = true;
+                if (command == "add_edge"){
+                    VertIndex u = read_vertex(), v = read_vertex();
+                    if (u == v)
+                        throw unidom::ConfigurableError("Edit script: add_edge with a single vertex.");
+                    if (add_edge(u,v))
+                        lower_bound--;
+                }else if (command == "remove_edge"){
+                    VertIndex u = read_vertex(), v = read_vertex();
+                    remove_edge(u,v);
+                }else if (command == "add_vertex"){
+                    adjacency.push_back(vector<VertIndex>());
+                    in_set.push_back(0);
+                    lower_bound++;
+                }else if (command == "remove_vertex"){
+                    remove_vertex(read_vertex());
+                    lower_bound--;
+                }else{
+                    throw unidom::ConfigurableError("Edit script: unknown edit \""+command+"\".");
+                }
+            }
+            if (!any_edits)
+                return false;
+
+            build_instance(inst);
+            repair_incumbent(inst);
+            if (lower_bound > 0)
+                inst.lower_bound_hint = lower_bound;
+            unidom::log << "Incumbent after edits: " << inst.incumbent.get_size() << ", lower bound hint: " << inst.lower_bound_hint << std::endl;
+            return true;
+        }
+    private:
+        bool started;
+        vector< vector<VertIndex> > adjacency;
+        vector<char> in_set; //Membership of the previous result (carried over the edits)
+
+        VertIndex read_vertex(){
+            long long v;
+            if (!(std::cin >> v) || v < 0 || v >= (long long)adjacency.size())
+                throw unidom::ConfigurableError("Edit script: invalid vertex index.");
+            return v;
+        }
+
+        //Both return false if the graph is unchanged
+        bool add_edge(VertIndex u, VertIndex v){
+            auto& N = adjacency[u];
+            if (std::find(N.begin(), N.end(), v) != N.end())
+                return false;
+            N.push_back(v);
+            adjacency[v].push_back(u);
+            return true;
+        }
+        bool remove_edge(VertIndex u, VertIndex v){
+            auto& Nu = adjacency[u];
+            auto& Nv = adjacency[v];
+            auto it = std::find(Nu.begin(), Nu.end(), v);
+            if (it == Nu.end())
+                return false;
+            Nu.erase(it);
+            Nv.erase(std::find(Nv.begin(), Nv.end(), u));
+            return true;
+        }
+        void remove_vertex(VertIndex v){
+            for(VertIndex u: vector<VertIndex>(adjacency[v]))
+                remove_edge(u,v);
+            adjacency.erase(adjacency.begin()+v);
+            in_set.erase(in_set.begin()+v);
+            for(auto& N: adjacency)
+                for(VertIndex& u: N)
+                    if (u > v)
+                        u--;
+        }
+
+        void build_instance(DominationInstance& inst){
+            int n = adjacency.size();
+            inst.G.reset(n);
+            for(VertIndex v = 0; v < n; v++)
+                inst.G[v].neighbours().assign(adjacency[v].begin(), adjacency[v].end());
+            inst.force_in.reset_empty();
+            inst.force_out.reset_empty();
+        }
+
+        void repair_incumbent(DominationInstance& inst){
+            Graph& G = inst.G;
+            int n = G.n();
+            //Number of vertices of the set in each closed neighbourhood
+            vector<int> dominators(n,0);
+            auto add = [&](VertIndex v, int delta){
+                dominators[v] += delta;
+                for(VertIndex u: G[v].neighbours())
+                    dominators[u] += delta;
+            };
+            for(VertIndex v = 0; v < n; v++)
+                if (in_set[v])
+                    add(v,1);
+            for(VertIndex v = 0; v < n; v++){
+                if (dominators[v] > 0)
+                    continue;
+                VertIndex best_vertex = v;
+                int best_gain = -1;
+                auto consider = [&](VertIndex w){
+                    int gain = (dominators[w] == 0)? 1 : 0;
+                    for(VertIndex u: G[w].neighbours())
+                        if (dominators[u] == 0)
+                            gain++;
+                    if (gain > best_gain){
+                        best_gain = gain;
+                        best_vertex = w;
+                    }
+                };
+                consider(v);
+                for(VertIndex u: G[v].neighbours())
+                    consider(u);
+                in_set[best_vertex] = 1;
+                add(best_vertex,1);
+            }
+            for(VertIndex v = 0; v < n; v++){
+                if (!in_set[v] || dominators[v] < 2)
+                    continue;
+                bool redundant = true;
+                for(VertIndex u: G[v].neighbours())
+                    if (dominators[u] < 2)
+                        redundant = false;
+                if (redundant){
+                    in_set[v] = 0;
+                    add(v,-1);
+                }
+            }
+            inst.incumbent.reset_empty();
+            for(VertIndex v = 0; v < n; v++)
+                if (in_set[v])
+                    inst.incumbent.add(v);
+        }
+    };
+
+}
+
+REGISTER_INPUT_SOURCE( EditScriptInputSource, "edit_script", "Read a graph (in the basic_input format) followed by edits (add_edge u v, remove_edge u v, add_vertex, remove_vertex v) from standard input, solving again after each \"solve\" line from the repaired previous result" );
@@ -23,11 +23,27 @@
 #include <string>
 #include <array>
 #include <algorithm>
+#include <cstdint>
 
 #include "unidom_constants.hpp"
 
 typedef int VertIndex;
 
+//Storage types for vertex indices and per-vertex counts (degrees, dominator counts, MDD
+//values) in the neighbour lists, vertex sets and search stacks. VertIndex itself stays an
+//int, for arithmetic and sentinel values like Graph::INVALID_VERTEX. Building with
+//COMPACT_INDICES=1 (which defines UNIDOM_COMPACT_INDICES) stores them in 16 bits instead,
+//halving the memory traffic of the neighbour loops and undo stacks.
+#ifdef UNIDOM_COMPACT_INDICES
+typedef std::uint16_t StoredVertIndex;
+typedef std::uint16_t StoredVertCount;
+//The vertex sets use MAX_VERTS+1 to mark vertices which are not in the set
+static_assert( unidom::MAX_VERTS < 0xffff, "UNIDOM_COMPACT_INDICES requires MAX_VERTS < 65535" );
+#else
+typedef VertIndex StoredVertIndex;
+typedef int StoredVertCount;
+#endif
+
 class GraphError{
 public:
     GraphError(std::string message){
@@ -43,7 +59,7 @@ private:
 class Graph{
 public:
     static const int INVALID_VERTEX = (VertIndex)(0x7fffffff);
-    typedef std::vector<VertIndex> neighbour_list;
+    typedef std::vector<StoredVertIndex> neighbour_list;
     class Vertex{
     friend class Graph;
     public:
@@ -119,6 +135,22 @@ public:
         }
     }
     
+    //The subgraph induced by the given vertices (vertex i of the result is vertices[i]).
+    void induced_subgraph( std::vector<VertIndex> vertices, Graph& result ){
+        std::vector<VertIndex> new_index(n(), (VertIndex)INVALID_VERTEX);
+        for(unsigned int i = 0; i < vertices.size(); i++)
+            new_index[vertices[i]] = i;
+        result.reset(vertices.size());
+        for(unsigned int i = 0; i < vertices.size(); i++){
+            Vertex& v_out = result[i];
+            Vertex& v_in = (*this)[vertices[i]];
+            v_out.real_index = v_in.real_index;
+            for( VertIndex neighbour: v_in.neighbours() )
+                if (new_index[neighbour] != INVALID_VERTEX)
+                    v_out.neighbours().push_back( new_index[neighbour] );
+        }
+    }
+    
     void add_edge_simple(VertIndex i, VertIndex j){
         Vertex& u = vertices[i];
         Vertex& v = vertices[j];
@@ -0,0 +1,586 @@
+/*  graph_file_input.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "unidom_common.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::InputSource;
+using unidom::DominationInstance;
+
+namespace{
+
+    //Smallest part of the file worth handing to a separate thread
+    const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    //The entries read from one chunk of the file, as arcs (tail, head). In METIS files,
+    //the tail is the number of the adjacency line within the chunk (vertex_lines counts
+    //them), and the lines of the earlier chunks are added afterwards.
+    struct ChunkResult{
+        vector< std::pair<uint32_t,uint32_t> > arcs;
+        unsigned long long lines = 0;
+        unsigned long long vertex_lines = 0;
+        long long max_index = -1; //Largest vertex index read (edge lists only)
+        bool failed = false;
+        unsigned long long failed_line = 0; //Line of the chunk (from 1) with the error
+        string reason;
+    };
+
+    struct AdjacencyStats{
+        unsigned long long entries = 0; //Arcs read (including the ones dropped below)
+        unsigned long long self_loops = 0;
+        unsigned long long repeated_arcs = 0; //Arcs (u,v) listed more than once
+        unsigned long long one_way_arcs = 0; //Arcs (u,v) listed without (v,u)
+        unsigned long long two_way_arcs = 0; //Arcs (u,v) listed along with (v,u)
+        unsigned long long edges = 0;
+    };
+
+    inline const char* find_line_end(const char* p, const char* end){
+        const char* line_end = (const char*)memchr(p, '\n', end-p);
+        return line_end? line_end : end;
+    }
+    inline void skip_blanks(const char*& p, const char* line_end){
+        while(p < line_end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+    }
+    //Reads a nonnegative integer (after any blanks)
+    inline bool read_number(const char*& p, const char* line_end, long long& value){
+        skip_blanks(p, line_end);
+        if (p == line_end || *p < '0' || *p > '9')
+            return false;
+        value = 0;
+        while(p < line_end && *p >= '0' && *p <= '9'){
+            value = value*10 + (*p-'0');
+            if (value > (1ll << 40))
+                return false;
+            p++;
+        }
+        return true;
+    }
+    //True if only blanks remain on the line
+    inline bool at_line_end(const char* p, const char* line_end){
+        skip_blanks(p, line_end);
+        return p == line_end;
+    }
+
+    //The contents of a graph file, mapped into memory (or read from standard input)
+    class FileContents{
+    public:
+        FileContents(): data(nullptr), size(0), mapping(nullptr) {}
+        FileContents(const FileContents&) = delete;
+        FileContents& operator=(const FileContents&) = delete;
+        ~FileContents(){
+            if (mapping)
+                munmap(mapping, size);
+        }
+        void map_file(const string& filename){
+            int fd = open(filename.c_str(), O_RDONLY);
+            struct stat st;
+            if (fd < 0 || fstat(fd, &st) != 0)
+                throw unidom::ConfigurableError("Unable to open graph file \""+filename+"\".");
+            size = st.st_size;
+            if (size > 0){
+                mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED){
+                    mapping = nullptr;
+                    close(fd);
+                    throw unidom::ConfigurableError("Unable to map graph file \""+filename+"\".");
+                }
+                madvise(mapping, size, MADV_SEQUENTIAL);
+                data = (const char*)mapping;
+            }
+            close(fd);
+        }
+        void read_stream(std::istream& stream){
+            buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+        }
+        const char* data;
+        size_t size;
+    private:
+        void* mapping;
+        string buffer;
+    };
+
+    //Builds the adjacency lists of the undirected graph on n vertices containing every
+    //arc of the chunks (in either direction), sorted and without repeats, as offsets into
+    //one contiguous array. Two counting sorts (by head, then by tail) leave the arcs of
+    //each tail sorted, so repeated arcs are adjacent, and a third (transposing the
+    //result) gives the sorted reverse arcs, which are merged with them.
+    void build_adjacency(int n, vector<ChunkResult>& chunks, const string& source_name,
+                         vector<size_t>& offsets, vector<uint32_t>& adjacency, AdjacencyStats& stats){
+        vector<unsigned long long> vertex_offset(chunks.size(), 0);
+        for(unsigned int c = 1; c < chunks.size(); c++)
+            vertex_offset[c] = vertex_offset[c-1] + chunks[c-1].vertex_lines;
+
+        vector<size_t> start(n+1, 0);
+        for(unsigned int c = 0; c < chunks.size(); c++){
+            stats.entries += chunks[c].arcs.size();
+            for(auto& arc: chunks[c].arcs){
+                unsigned long long tail = arc.first + vertex_offset[c];
+                if (tail >= (unsigned long long)n)
+                    throw unidom::ConfigurableError(source_name+": adjacency list for vertex "+std::to_string(tail+1)+", but the header declares "+std::to_string(n)+" vertices.");
+                if (tail == arc.second)
+                    stats.self_loops++;
+                else
+                    start[arc.second+1]++;
+            }
+        }
+        for(int v = 0; v < n; v++)
+            start[v+1] += start[v];
+        size_t num_arcs = start[n];
+        vector<uint32_t> tails_by_head(num_arcs);
+        vector<size_t> position(start.begin(), start.end()-1);
+        for(unsigned int c = 0; c < chunks.size(); c++){
+            for(auto& arc: chunks[c].arcs){
+                uint32_t tail = arc.first + vertex_offset[c];
+                if (tail != arc.second)
+                    tails_by_head[position[arc.second]++] = tail;
+            }
+            vector< std::pair<uint32_t,uint32_t> >().swap(chunks[c].arcs);
+        }
+
+        //Heads grouped by tail, in increasing order
+        vector<size_t> out_start(n+1, 0);
+        for(uint32_t tail: tails_by_head)
+            out_start[tail+1]++;
+        for(int v = 0; v < n; v++)
+            out_start[v+1] += out_start[v];
+        vector<uint32_t> heads(num_arcs);
+        position.assign(out_start.begin(), out_start.end()-1);
+        for(int head = 0; head < n; head++)
+            for(size_t i = start[head]; i < start[head+1]; i++)
+                heads[position[tails_by_head[i]]++] = head;
+        vector<uint32_t>().swap(tails_by_head);
+
+        //Drop repeated arcs (now adjacent)
+        size_t kept = 0;
+        for(int v = 0; v < n; v++){
+            size_t row_begin = out_start[v];
+            out_start[v] = kept;
+            for(size_t i = row_begin; i < position[v]; i++){
+                if (i > row_begin && heads[i] == heads[i-1]){
+                    stats.repeated_arcs++;
+                    continue;
+                }
+                heads[kept++] = heads[i];
+            }
+        }
+        out_start[n] = kept;
+
+        //Tails grouped by head, in increasing order
+        vector<size_t> in_start(n+1, 0);
+        for(size_t i = 0; i < kept; i++)
+            in_start[heads[i]+1]++;
+        for(int v = 0; v < n; v++)
+            in_start[v+1] += in_start[v];
+        vector<uint32_t> tails(kept);
+        position.assign(in_start.begin(), in_start.end()-1);
+        for(int tail = 0; tail < n; tail++)
+            for(size_t i = out_start[tail]; i < out_start[tail+1]; i++)
+                tails[position[heads[i]]++] = tail;
+
+        //The neighbours of v are the union of its heads and its tails
+        offsets.assign(n+1, 0);
+        adjacency.clear();
+        adjacency.reserve(2*kept);
+        for(int v = 0; v < n; v++){
+            size_t i = out_start[v], j = in_start[v];
+            while(i < out_start[v+1] || j < in_start[v+1]){
+                if (j == in_start[v+1] || (i < out_start[v+1] && heads[i] < tails[j])){
+                    adjacency.push_back(heads[i++]);
+                    stats.one_way_arcs++;
+                }else if (i == out_start[v+1] || tails[j] < heads[i]){
+                    adjacency.push_back(tails[j++]);
+                }else{
+                    adjacency.push_back(heads[i]);
+                    stats.two_way_arcs++;
+                    i++;
+                    j++;
+                }
+            }
+            offsets[v+1] = adjacency.size();
+        }
+        stats.edges = adjacency.size()/2;
+    }
+
+    //Common part of the input sources for graph files in other formats. Each file given
+    //with -file (which may be repeated) is one instance; without -file, a single graph
+    //is read from standard input. The file is mapped into memory and split into chunks
+    //at line boundaries, which are parsed by -threads T threads, and the adjacency lists
+    //are built from the entries of all chunks with counting sorts (see build_adjacency).
+    //Self-loops and repeated edges are dropped, and the graph is made symmetric; what
+    //was changed is reported on the log by each format.
+    class GraphFileInputSource: public InputSource{
+    public:
+        GraphFileInputSource(): num_threads(std::max(1u, std::thread::hardware_concurrency())), files_read(0) {}
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-file")
+                filenames.push_back(parser.get_next_string());
+            else if (arg == "-threads"){
+                num_threads = parser.get_next_unsigned_int();
+                if (num_threads == 0)
+                    throw unidom::ConfigurableError("Parameter -threads must be at least 1.");
+            }else
+                return InputSource::accept_argument(arg,parser);
+            return true;
+        }
+
+        bool read_next(DominationInstance& inst){
+            FileContents contents;
+            string source_name;
+            if (filenames.size() == 0){
+                if (files_read > 0)
+                    return false;
+                contents.read_stream(std::cin);
+                source_name = "standard input";
+            }else{
+                if (files_read >= filenames.size())
+                    return false;
+                source_name = filenames[files_read];
+                contents.map_file(source_name);
+            }
+            files_read++;
+            read_graph_file(contents.data, contents.data+contents.size, source_name, inst);
+            return true;
+        }
+    protected:
+        //Set by parse_header (-1 if not given)
+        long long header_vertices, header_edges;
+
+        //Reads the header of the file starting at begin and returns the start of the
+        //rest of the file
+        virtual const char* parse_header(const char* begin, const char* end, const string& source_name) = 0;
+        //Reads the entries of the lines in [begin,end) into R (returning early with
+        //R.failed set if a line is malformed)
+        virtual void parse_chunk(const char* begin, const char* end, ChunkResult& R) = 0;
+        //Logs anything unusual about the file
+        virtual void report(AdjacencyStats& stats, const string& source_name) = 0;
+
+    private:
+        vector<string> filenames;
+        unsigned int num_threads;
+        unsigned int files_read;
+
+        void read_graph_file(const char* begin, const char* end, const string& source_name, DominationInstance& inst){
+            header_vertices = header_edges = -1;
+            const char* body = parse_header(begin, end, source_name);
+            unsigned long long header_lines = std::count(begin, body, '\n');
+
+            vector<const char*> bounds = split_chunks(body, end);
+            vector<ChunkResult> chunks(bounds.size()-1);
+            if (chunks.size() == 1){
+                parse_chunk(bounds[0], bounds[1], chunks[0]);
+            }else{
+                vector<std::thread> workers;
+                for(unsigned int i = 0; i < chunks.size(); i++)
+                    workers.emplace_back([&,i](){
+                        parse_chunk(bounds[i], bounds[i+1], chunks[i]);
+                    });
+                for(auto& worker: workers)
+                    worker.join();
+            }
+            unsigned long long line_number = header_lines;
+            long long max_index = -1;
+            for(auto& R: chunks){
+                if (R.failed)
+                    throw unidom::ConfigurableError(source_name+", line "+std::to_string(line_number+R.failed_line)+": "+R.reason);
+                line_number += R.lines;
+                max_index = std::max(max_index, R.max_index);
+            }
+
+            long long n = (header_vertices >= 0)? header_vertices : max_index+1;
+            if (n >= unidom::MAX_VERTS)
+                throw unidom::ConfigurableError(source_name+": the graph has "+std::to_string(n)+" vertices, but at most "+std::to_string(unidom::MAX_VERTS-1)
+                                                +" are supported (rebuild with a larger MAX_VERTS).");
+
+            AdjacencyStats stats;
+            vector<size_t> offsets;
+            vector<uint32_t> adjacency;
+            build_adjacency(n, chunks, source_name, offsets, adjacency, stats);
+
+            inst.G.reset(n);
+            for(VertIndex v = 0; v < n; v++)
+                inst.G[v].neighbours().assign(adjacency.begin()+offsets[v], adjacency.begin()+offsets[v+1]);
+            inst.force_in.reset_empty();
+            inst.force_out.reset_empty();
+
+            unidom::log << "Read " << n << " vertices and " << stats.edges << " edges from " << source_name << " (" << chunks.size() << " chunk" << ((chunks.size() == 1)? "":"s") << ")" << std::endl;
+            if (stats.self_loops > 0)
+                unidom::log << "Ignored " << stats.self_loops << " self-loop" << ((stats.self_loops == 1)? "":"s") << std::endl;
+            report(stats, source_name);
+        }
+
+        //Boundaries of up to num_threads chunks of [begin,end), each ending just after a
+        //newline (or at the end)
+        vector<const char*> split_chunks(const char* begin, const char* end){
+            size_t chunk_count = std::max<size_t>(1, std::min<size_t>(num_threads, (end-begin)/MIN_CHUNK_BYTES));
+            size_t chunk_bytes = (end-begin)/chunk_count;
+            vector<const char*> bounds;
+            bounds.push_back(begin);
+            const char* position = begin;
+            for(size_t i = 0; i+1 < chunk_count && position < end; i++){
+                const char* chunk_end = position + std::min(chunk_bytes, (size_t)(end-position));
+                while(chunk_end < end && chunk_end[-1] != '\n')
+                    chunk_end++;
+                bounds.push_back(chunk_end);
+                position = chunk_end;
+            }
+            if (position < end || bounds.size() == 1)
+                bounds.push_back(end);
+            return bounds;
+        }
+    };
+
+    //DIMACS graphs: a "p edge n m" line (after any "c" comment lines) followed by "e u v"
+    //lines, with vertices numbered from 1 (as in the graph colouring benchmarks)
+    class DIMACSInputSource: public GraphFileInputSource{
+    protected:
+        const char* parse_header(const char* begin, const char* end, const string& source_name){
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = find_line_end(p, end);
+                const char* next_line = (line_end < end)? line_end+1 : end;
+                const char* q = p;
+                skip_blanks(q, line_end);
+                if (q == line_end || *q == 'c'){
+                    p = next_line;
+                    continue;
+                }
+                if (*q != 'p')
+                    break;
+                //The problem name (usually "edge" or "col") is not checked
+                q++;
+                skip_blanks(q, line_end);
+                while(q < line_end && *q != ' ' && *q != '\t')
+                    q++;
+                if (!read_number(q, line_end, header_vertices) || !read_number(q, line_end, header_edges) || !at_line_end(q, line_end))
+                    throw unidom::ConfigurableError(source_name+": malformed DIMACS \"p\" line (expected \"p edge n m\").");
+                return next_line;
+            }
+            throw unidom::ConfigurableError(source_name+": no DIMACS \"p edge n m\" line before the edges.");
+        }
+
+        void parse_chunk(const char* begin, const char* end, ChunkResult& R){
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = find_line_end(p, end);
+                R.lines++;
+                const char* q = p;
+                p = (line_end < end)? line_end+1 : end;
+                skip_blanks(q, line_end);
+                if (q == line_end || *q == 'c')
+                    continue;
+                long long u, v;
+                if (*q != 'e' || !read_number(++q, line_end, u) || !read_number(q, line_end, v) || !at_line_end(q, line_end)){
+                    fail(R, "expected an edge line \"e u v\"");
+                    return;
+                }
+                if (u < 1 || u > header_vertices || v < 1 || v > header_vertices){
+                    fail(R, "vertex "+std::to_string((u < 1 || u > header_vertices)? u : v)+" is not between 1 and "+std::to_string(header_vertices));
+                    return;
+                }
+                R.arcs.emplace_back(u-1, v-1);
+            }
+        }
+
+        void report(AdjacencyStats& stats, const string& source_name){
+            unsigned long long duplicates = stats.repeated_arcs + stats.two_way_arcs/2;
+            if (duplicates > 0)
+                unidom::log << "Removed " << duplicates << " duplicate edge" << ((duplicates == 1)? "":"s") << std::endl;
+            if ((unsigned long long)header_edges != stats.entries)
+                unidom::log << "Warning: the \"p\" line of " << source_name << " declares " << header_edges << " edges, but " << stats.entries << " were listed" << std::endl;
+        }
+    private:
+        static void fail(ChunkResult& R, string reason){
+            R.failed = true;
+            R.failed_line = R.lines;
+            R.reason = reason;
+        }
+    };
+
+    //METIS graphs: a header "n m [fmt [ncon]]" (after any "%" comment lines) followed by
+    //one line per vertex listing its neighbours (numbered from 1). Vertex sizes, vertex
+    //weights and edge weights (as given by fmt) are skipped. The lists should be
+    //symmetric; when they are not, the missing reverse entries are added and counted.
+    class METISInputSource: public GraphFileInputSource{
+    protected:
+        const char* parse_header(const char* begin, const char* end, const string& source_name){
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = find_line_end(p, end);
+                const char* next_line = (line_end < end)? line_end+1 : end;
+                const char* q = p;
+                skip_blanks(q, line_end);
+                if (q < line_end && *q == '%'){
+                    p = next_line;
+                    continue;
+                }
+                long long format = 0, constraints = 1;
+                if (!read_number(q, line_end, header_vertices) || !read_number(q, line_end, header_edges))
+                    throw unidom::ConfigurableError(source_name+": malformed METIS header (expected \"n m [fmt [ncon]]\").");
+                if (read_number(q, line_end, format))
+                    read_number(q, line_end, constraints);
+                if (!at_line_end(q, line_end) || format % 10 > 1 || format/10 % 10 > 1 || format/100 > 1)
+                    throw unidom::ConfigurableError(source_name+": malformed METIS header (expected \"n m [fmt [ncon]]\").");
+                edge_weights = format % 10 == 1;
+                vertex_values = ((format/10 % 10 == 1)? constraints : 0) + ((format/100 == 1)? 1 : 0);
+                return next_line;
+            }
+            throw unidom::ConfigurableError(source_name+": no METIS header line.");
+        }
+
+        void parse_chunk(const char* begin, const char* end, ChunkResult& R){
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = find_line_end(p, end);
+                R.lines++;
+                const char* q = p;
+                p = (line_end < end)? line_end+1 : end;
+                skip_blanks(q, line_end);
+                if (q < line_end && *q == '%')
+                    continue;
+                uint32_t vertex = R.vertex_lines++;
+                long long value;
+                for(int i = 0; i < vertex_values; i++)
+                    if (!read_number(q, line_end, value)){
+                        fail(R, "missing vertex size or weight");
+                        return;
+                    }
+                long long neighbour;
+                while(read_number(q, line_end, neighbour)){
+                    if (neighbour < 1 || neighbour > header_vertices){
+                        fail(R, "vertex "+std::to_string(neighbour)+" is not between 1 and "+std::to_string(header_vertices));
+                        return;
+                    }
+                    if (edge_weights && !read_number(q, line_end, value)){
+                        fail(R, "missing edge weight");
+                        return;
+                    }
+                    R.arcs.emplace_back(vertex, neighbour-1);
+                }
+                if (!at_line_end(q, line_end)){
+                    fail(R, "malformed adjacency line");
+                    return;
+                }
+            }
+        }
+
+        void report(AdjacencyStats& stats, const string& source_name){
+            if (stats.repeated_arcs > 0)
+                unidom::log << "Removed " << stats.repeated_arcs << " repeated entr" << ((stats.repeated_arcs == 1)? "y":"ies") << std::endl;
+            if (stats.one_way_arcs > 0)
+                unidom::log << "Warning: the adjacency lists of " << source_name << " are not symmetric (" << stats.one_way_arcs
+                            << " entries have no reverse entry); the missing entries were added" << std::endl;
+            if ((unsigned long long)header_edges != stats.edges)
+                unidom::log << "Warning: the header of " << source_name << " declares " << header_edges << " edges, but the graph has " << stats.edges << std::endl;
+        }
+    private:
+        bool edge_weights;
+        int vertex_values; //Vertex sizes and weights before the neighbours on each line
+
+        static void fail(ChunkResult& R, string reason){
+            R.failed = true;
+            R.failed_line = R.lines;
+            R.reason = reason;
+        }
+    };
+
+    //Edge lists: one edge "u v" per line (any further columns, such as weights, are
+    //ignored), with "#" or "%" comment lines. Vertices are numbered from 0 (or from 1 with
+    //-one_based), and the number of vertices is one more than the largest index. Each
+    //edge may be listed in one or both directions.
+    class EdgeListInputSource: public GraphFileInputSource{
+    public:
+        EdgeListInputSource(): first_index(0) {}
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-one_based")
+                first_index = 1;
+            else
+                return GraphFileInputSource::accept_argument(arg,parser);
+            return true;
+        }
+    protected:
+        const char* parse_header(const char* begin, const char* end, const string& source_name){
+            return begin;
+        }
+
+        void parse_chunk(const char* begin, const char* end, ChunkResult& R){
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = find_line_end(p, end);
+                R.lines++;
+                const char* q = p;
+                p = (line_end < end)? line_end+1 : end;
+                skip_blanks(q, line_end);
+                if (q == line_end || *q == '#' || *q == '%')
+                    continue;
+                long long u, v;
+                if (!read_number(q, line_end, u) || !read_number(q, line_end, v) || (q < line_end && *q != ' ' && *q != '\t' && *q != '\r')){
+                    R.failed = true;
+                    R.failed_line = R.lines;
+                    R.reason = "expected an edge \"u v\"";
+                    return;
+                }
+                if (u < first_index || v < first_index || u-first_index >= unidom::MAX_VERTS || v-first_index >= unidom::MAX_VERTS){
+                    R.failed = true;
+                    R.failed_line = R.lines;
+                    R.reason = "vertex "+std::to_string((u < first_index || u-first_index >= unidom::MAX_VERTS)? u : v)+" is out of range";
+                    return;
+                }
+                R.arcs.emplace_back(u-first_index, v-first_index);
+                R.max_index = std::max(R.max_index, std::max(u,v)-first_index);
+            }
+        }
+
+        void report(AdjacencyStats& stats, const string& source_name){
+            if (stats.repeated_arcs > 0)
+                unidom::log << "Removed " << stats.repeated_arcs << " repeated edge" << ((stats.repeated_arcs == 1)? "":"s") << std::endl;
+            //Mixing edges listed once with edges listed in both directions usually means
+            //that a symmetric list is missing some entries
+            if (stats.one_way_arcs > 0 && stats.two_way_arcs > 0)
+                unidom::log << "Warning: some edges of " << source_name << " are listed in both directions (" << stats.two_way_arcs/2
+                            << ") and others in only one (" << stats.one_way_arcs << ")" << std::endl;
+        }
+    private:
+        int first_index;
+    };
+
+}
+
+REGISTER_INPUT_SOURCE( DIMACSInputSource, "dimacs", "Read a DIMACS graph (\"p edge n m\" and \"e u v\" lines) from each -file F (or standard input), parsing in -threads T threads");
+REGISTER_INPUT_SOURCE( METISInputSource, "metis", "Read a METIS graph (header \"n m [fmt [ncon]]\" and one adjacency line per vertex) from each -file F (or standard input), parsing in -threads T threads");
+REGISTER_INPUT_SOURCE( EdgeListInputSource, "edgelist", "Read a list of edges \"u v\" (numbered from 0, or from 1 with -one_based) from each -file F (or standard input), parsing in -threads T threads");
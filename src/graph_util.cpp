@@ -19,11 +19,14 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include "graph.hpp"
 #include "graph_util.hpp"
 
 using unidom::MAX_DEGREE;
 using unidom::MAX_VERTS;
+using std::vector;
 
 
 bool read_graph(std::istream& f, Graph& g){
@@ -56,4 +59,148 @@ void write_graph(std::ostream& f, Graph& g){
             f << u << " ";
         f << std::endl;
     }
-}
\ No newline at end of file
+}
+namespace{
+    vector< vector<char> > adjacency_matrix(Graph& g){
+        int n = g.n();
+        vector< vector<char> > M(n, vector<char>(n,0));
+        for(int i = 0; i < n; i++)
+            for(VertIndex u: g[i].neighbours())
+                M[i][u] = 1;
+        return M;
+    }
+}
+
+CliqueCover greedy_clique_cover(Graph& g){
+    int n = g.n();
+    vector< vector<char> > adjacent = adjacency_matrix(g);
+    vector< vector<char> > covered(n, vector<char>(n,0));
+    CliqueCover cover;
+    for(int u = 0; u < n; u++){
+        for(VertIndex v: g[u].neighbours()){
+            if (v <= u || covered[u][v])
+                continue;
+            vector<VertIndex> clique = {(VertIndex)u, v};
+            for(VertIndex w: g[u].neighbours()){
+                if (w == u || w == v) //Self-loops are allowed in the input
+                    continue;
+                bool adjacent_to_all = true;
+                for(VertIndex x: clique)
+                    if (!adjacent[w][x]){
+                        adjacent_to_all = false;
+                        break;
+                    }
+                if (adjacent_to_all)
+                    clique.push_back(w);
+            }
+            for(VertIndex x: clique)
+                for(VertIndex y: clique)
+                    covered[x][y] = 1;
+            cover.push_back(clique);
+        }
+    }
+    return cover;
+}
+
+bool is_clique_cover(Graph& g, CliqueCover& cover){
+    int n = g.n();
+    vector< vector<char> > adjacent = adjacency_matrix(g);
+    vector< vector<char> > covered(n, vector<char>(n,0));
+    for(auto& clique: cover){
+        for(VertIndex x: clique){
+            if (x < 0 || x >= n)
+                return false;
+            for(VertIndex y: clique){
+                if (x == y)
+                    continue;
+                if (!adjacent[x][y])
+                    return false;
+                covered[x][y] = 1;
+            }
+        }
+    }
+    for(int u = 0; u < n; u++)
+        for(VertIndex v: g[u].neighbours())
+            if (v != u && !covered[u][v])
+                return false;
+    return true;
+}
+
+vector< vector<VertIndex> > connected_components(Graph& g){
+    int n = g.n();
+    vector< vector<VertIndex> > components;
+    vector<char> visited(n,0);
+    for(int root = 0; root < n; root++){
+        if (visited[root])
+            continue;
+        vector<VertIndex> component;
+        component.push_back(root);
+        visited[root] = 1;
+        for(unsigned int i = 0; i < component.size(); i++)
+            for(VertIndex v: g[component[i]].neighbours())
+                if (!visited[v]){
+                    visited[v] = 1;
+                    component.push_back(v);
+                }
+        std::sort(component.begin(), component.end());
+        components.push_back(component);
+    }
+    return components;
+}
+
+bool is_automorphism(Graph& g, vector<VertIndex>& p){
+    int n = g.n();
+    if ((int)p.size() != n)
+        return false;
+    vector<char> seen(n,0);
+    for(VertIndex v: p){
+        if (v < 0 || v >= n || seen[v])
+            return false;
+        seen[v] = 1;
+    }
+    //Every edge must be mapped to an edge (with equal degrees, this makes p a bijection on edges)
+    vector< vector<VertIndex> > sorted_neighbours(n);
+    for(int v = 0; v < n; v++){
+        sorted_neighbours[v].assign(g[v].neighbours().begin(), g[v].neighbours().end());
+        std::sort(sorted_neighbours[v].begin(), sorted_neighbours[v].end());
+    }
+    for(int v = 0; v < n; v++){
+        vector<VertIndex>& image_neighbours = sorted_neighbours[p[v]];
+        if (image_neighbours.size() != sorted_neighbours[v].size())
+            return false;
+        for(VertIndex u: sorted_neighbours[v])
+            if (!std::binary_search(image_neighbours.begin(), image_neighbours.end(), p[u]))
+                return false;
+    }
+    return true;
+}
+
+vector< vector<VertIndex> > permutation_orbits(Graph& g, vector< vector<VertIndex> >& generators){
+    int n = g.n();
+    //Union-find over the cycles of the generators
+    vector<VertIndex> parent(n);
+    for(int v = 0; v < n; v++)
+        parent[v] = v;
+    auto find = [&parent](VertIndex v){
+        while(parent[v] != v)
+            v = parent[v] = parent[parent[v]];
+        return v;
+    };
+    for(auto& p: generators)
+        for(int v = 0; v < n; v++){
+            VertIndex a = find(v), b = find(p[v]);
+            if (a != b)
+                parent[std::max(a,b)] = std::min(a,b);
+        }
+    vector< vector<VertIndex> > orbits;
+    vector<int> orbit_of(n,-1);
+    for(int v = 0; v < n; v++){
+        VertIndex root = find(v);
+        if (orbit_of[root] < 0){
+            orbit_of[root] = orbits.size();
+            orbits.push_back(vector<VertIndex>());
+        }
+        orbits[orbit_of[root]].push_back(v);
+    }
+    return orbits;
+}
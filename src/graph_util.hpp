@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "graph.hpp"
 #include "unidom_common.hpp"
 
@@ -28,6 +29,27 @@ bool read_graph(std::istream& f, Graph& g);
 
 void write_graph(std::ostream& f, Graph& g);
 
+typedef std::vector< std::vector<VertIndex> > CliqueCover;
+
+//Build an edge clique cover greedily (each uncovered edge is extended to a maximal
+//clique by adding common neighbours in neighbour list order).
+CliqueCover greedy_clique_cover(Graph& g);
+
+//Returns true if every set in the cover is a clique of g and every edge of g
+//is contained in at least one of them.
+bool is_clique_cover(Graph& g, CliqueCover& cover);
+
+//The vertex sets of the connected components of g (each in increasing order),
+//ordered by their smallest vertex.
+std::vector< std::vector<VertIndex> > connected_components(Graph& g);
+
+//Returns true if p (mapping each vertex v to p[v]) is an automorphism of g.
+bool is_automorphism(Graph& g, std::vector<VertIndex>& p);
+
+//The orbits of the group generated by the given permutations of the vertices of g
+//(each in increasing order), ordered by their smallest vertex.
+std::vector< std::vector<VertIndex> > permutation_orbits(Graph& g, std::vector< std::vector<VertIndex> >& generators);
+
 inline std::ostream& operator<<(std::ostream& f, Graph& g){
     write_graph(f,g);
     return f;
@@ -46,22 +46,30 @@ public:
     bool accept_argument(std::string arg, unidom::ArgumentTokenizer& parser){
         if (parameters.find(arg) != parameters.end()){
             set_parameter(arg,parser.get_next_unsigned_int());
+        }else if (double_parameters.find(arg) != double_parameters.end()){
+            set_double_parameter(arg,parser.get_next_double());
+        }else if (arg == "-count"){
+            instance_count = parser.get_next_unsigned_int();
         }else
             return unidom::InputSource::accept_argument(arg,parser);
         return true;
     }
     
-    SingleGraphGeneratorBase(): already_generated(false){}
+    SingleGraphGeneratorBase(): instances_generated(0), instance_count(1){}
     
     
     bool read_next(DominationInstance& inst){
         for(auto P: parameters){
             if (!P.second.set)
-                throw unidom::ConfigurableError("Parameter -n missing for generator \""+name()+"\".");
+                throw unidom::ConfigurableError("Parameter "+P.first+" missing for generator \""+name()+"\".");
         }
-        if (already_generated)
+        for(auto P: double_parameters){
+            if (!P.second.set)
+                throw unidom::ConfigurableError("Parameter "+P.first+" missing for generator \""+name()+"\".");
+        }
+        if (instances_generated >= instance_count)
             return false;
-        already_generated = true;
+        instances_generated++;
         inst.force_in.reset_empty();
         inst.force_out.reset_empty();
         
@@ -77,24 +85,41 @@ private:
         bool set;
         string name;
     };
+    struct DoubleParameterProxy{
+        DoubleParameterProxy(double& p, string name): parameter(&p), set(false), name(name) {}
+        double* parameter;
+        bool set;
+        string name;
+    };
     map<string, IntParameterProxy> parameters;
+    map<string, DoubleParameterProxy> double_parameters;
 protected:
     void add_parameter(int& p, string name){
         parameters.insert(std::make_pair(name,IntParameterProxy(p,name)));
     }
+    void add_parameter(double& p, string name){
+        double_parameters.insert(std::make_pair(name,DoubleParameterProxy(p,name)));
+    }
     void set_parameter(string name, int value){
         auto& P = parameters.at(name);
         *P.parameter = value;
         P.set = true;
     }
+    void set_double_parameter(string name, double value){
+        auto& P = double_parameters.at(name);
+        *P.parameter = value;
+        P.set = true;
+    }
     virtual void generate(DominationInstance& inst) = 0;
     
 private:
-    bool already_generated;
+    unsigned int instances_generated;
+    unsigned int instance_count; //Number of instances to generate (with -count)
 };
 
 #define ADD_PARAMETER(p) add_parameter(p, "-"#p )
 #define ADD_PARAMETER_DEFAULT(p, d) { add_parameter(p, "-"#p ); set_parameter("-"#p, d); }
+#define ADD_DOUBLE_PARAMETER_DEFAULT(p, d) { add_parameter(p, "-"#p ); set_double_parameter("-"#p, d); }
 
 
 
@@ -171,7 +196,47 @@ protected:
                 
         delete Mstorage;
         
+        //With radius 1, the words which differ only in one coordinate form a clique,
+        //and these cliques cover all edges
+        inst.clique_cover.clear();
+        if (r == 1 && base > 1){
+            for(int i = 0; i < num_verts; i++){
+                vector<int> digits = get_digits(i);
+                for(int j = 0; j < n; j++){
+                    if (digits[j] != 0)
+                        continue;
+                    vector<VertIndex> clique;
+                    for(int k = 0; k < base; k++){
+                        digits[j] = k;
+                        clique.push_back(get_index(digits));
+                    }
+                    digits[j] = 0;
+                    inst.clique_cover.push_back(clique);
+                }
+            }
+        }
         
+        //Permuting the symbols of one coordinate, or permuting the coordinates, preserves
+        //Hamming distances. These are generated by the transposition and cycle of the
+        //symbols of the first coordinate and the transposition and cycle of the coordinates.
+        auto word_permutation = [&](std::function< void(vector<int>&) > word_map){
+            vector<VertIndex> p(num_verts);
+            for(int i = 0; i < num_verts; i++){
+                vector<int> digits = get_digits(i);
+                word_map(digits);
+                p[i] = get_index(digits);
+            }
+            inst.automorphism_generators.push_back(p);
+        };
+        inst.automorphism_generators.clear();
+        if (base > 1)
+            word_permutation([](vector<int>& digits){ digits[0] = (digits[0] < 2)? 1-digits[0] : digits[0]; });
+        if (base > 2)
+            word_permutation([this](vector<int>& digits){ digits[0] = (digits[0]+1)%base; });
+        if (n > 1)
+            word_permutation([](vector<int>& digits){ std::swap(digits[0],digits[1]); });
+        if (n > 2)
+            word_permutation([](vector<int>& digits){ std::rotate(digits.begin(), digits.begin()+1, digits.end()); });
     }
 private:
 
@@ -256,7 +321,27 @@ protected:
             }
         }
         
-        
+        //The symmetric group on the n points acts on the k-subsets, and is generated
+        //by the transposition (0 1) and the cycle (0 1 ... n-1)
+        map<int, VertIndex> index_of;
+        for(int i = 0; i < num_verts; i++)
+            index_of[vertices[i]] = i;
+        auto subset_permutation = [&](std::function< int(int) > point_map){
+            vector<VertIndex> p(num_verts);
+            for(int i = 0; i < num_verts; i++){
+                int image = 0;
+                for(int j = 0; j < n; j++)
+                    if (vertices[i] & (1<<j))
+                        image |= 1<<point_map(j);
+                p[i] = index_of[image];
+            }
+            inst.automorphism_generators.push_back(p);
+        };
+        inst.automorphism_generators.clear();
+        if (n > 1){
+            subset_permutation([](int j){ return (j < 2)? 1-j : j; });
+            subset_permutation([this](int j){ return (j+1)%n; });
+        }
     }
 private:
 
@@ -297,6 +382,261 @@ REGISTER_INPUT_SOURCE( KneserGenerator, "kneser", "Generates a Kneser graph: -n
 
 
 
+/* Random Graph Generators */
+/* All of these draw from unidom::random_in_range (or unidom::random_unit_interval), so
+   the generated graphs are determined by the -seed option. With -count, each instance
+   continues the same random sequence. */
+
+class RandomGraphGeneratorBase: public SingleGraphGeneratorBase{
+protected:
+    void check_vertex_count(int n){
+        if (n < 1)
+            throw unidom::ConfigurableError("Parameter -n for generator \""+name()+"\" must be at least 1.");
+        if (n >= unidom::MAX_VERTS)
+            throw unidom::ConfigurableError("Parameter -n for generator \""+name()+"\" must be less than "+std::to_string(unidom::MAX_VERTS)+".");
+    }
+    void check_probability(double p, string parameter_name){
+        if (p < 0 || p > 1)
+            throw unidom::ConfigurableError("Parameter "+parameter_name+" for generator \""+name()+"\" must be between 0 and 1.");
+    }
+    //Neighbour lists are sorted so the output depends only on the edge set
+    void sort_neighbours(Graph& G){
+        for(auto& v: G.V())
+            std::sort(v.neighbours().begin(), v.neighbours().end());
+    }
+};
+
+
+/* Erdos-Renyi G(n,p) Generator */
+class GnpGenerator: public RandomGraphGeneratorBase{
+public:
+    GnpGenerator(){
+        ADD_PARAMETER(n);
+        ADD_PARAMETER(p);
+    }
+protected:
+    void generate(DominationInstance& inst){
+        check_vertex_count(n);
+        check_probability(p,"-p");
+        Graph& G = inst.G;
+        G.reset(n);
+        for(int i = 0; i < n; i++){
+            for(int j = i+1; j < n; j++){
+                if (unidom::random_unit_interval() < p){
+                    G[i].neighbours().push_back(j);
+                    G[j].neighbours().push_back(i);
+                }
+            }
+        }
+    }
+private:
+    int n;
+    double p;
+};
+REGISTER_INPUT_SOURCE( GnpGenerator, "gnp", "Generates a random graph G(n,p): -n sets the number of vertices, -p the probability of each edge (use -count for multiple graphs).");
+
+
+/* Erdos-Renyi G(n,m) Generator */
+class GnmGenerator: public RandomGraphGeneratorBase{
+public:
+    GnmGenerator(){
+        ADD_PARAMETER(n);
+        ADD_PARAMETER(m);
+    }
+protected:
+    void generate(DominationInstance& inst){
+        check_vertex_count(n);
+        Graph& G = inst.G;
+        
+        vector< std::pair<int,int> > all_edges;
+        for(int i = 0; i < n; i++)
+            for(int j = i+1; j < n; j++)
+                all_edges.push_back(std::make_pair(i,j));
+        if (m < 0 || m > all_edges.size())
+            throw unidom::ConfigurableError("Parameter -m for generator \""+name()+"\" must be at most "+std::to_string(all_edges.size())+".");
+        
+        //Partial Fisher-Yates shuffle to choose m distinct edges
+        G.reset(n);
+        for(int k = 0; k < m; k++){
+            int idx = unidom::random_in_range(k, all_edges.size()-1);
+            std::swap(all_edges[k], all_edges[idx]);
+            G[all_edges[k].first].neighbours().push_back(all_edges[k].second);
+            G[all_edges[k].second].neighbours().push_back(all_edges[k].first);
+        }
+        sort_neighbours(G);
+    }
+private:
+    int n;
+    int m;
+};
+REGISTER_INPUT_SOURCE( GnmGenerator, "gnm", "Generates a random graph G(n,m): -n sets the number of vertices, -m the number of edges (use -count for multiple graphs).");
+
+
+/* Random Regular Graph Generator */
+/* Uses the pairing model, rejecting pairs which would create loops or multiple
+   edges (as in Steger and Wormald (1999)) and restarting if no valid pair remains. */
+class RandomRegularGenerator: public RandomGraphGeneratorBase{
+public:
+    RandomRegularGenerator(){
+        ADD_PARAMETER(n);
+        ADD_PARAMETER(d);
+    }
+protected:
+    void generate(DominationInstance& inst){
+        check_vertex_count(n);
+        if (d < 0)
+            throw unidom::ConfigurableError("Parameter -d for generator \""+name()+"\" must be non-negative.");
+        if (d >= n)
+            throw unidom::ConfigurableError("Parameter -d for generator \""+name()+"\" must be less than -n.");
+        if ((n*d)%2 != 0)
+            throw unidom::ConfigurableError("Generator \""+name()+"\" requires n*d to be even.");
+        Graph& G = inst.G;
+        while(!try_generate(G))
+            ;
+        sort_neighbours(G);
+    }
+private:
+    bool try_generate(Graph& G){
+        const int ATTEMPTS_BEFORE_CHECK = 100;
+        G.reset(n);
+        vector< vector<bool> > adjacent(n, vector<bool>(n,false));
+        vector<int> points;
+        for(int v = 0; v < n; v++)
+            for(int k = 0; k < d; k++)
+                points.push_back(v);
+        
+        auto suitable = [&](int u, int v){
+            return u != v && !adjacent[u][v];
+        };
+        while(points.size() > 0){
+            int i = -1, j = -1;
+            for(int attempt = 0; attempt < ATTEMPTS_BEFORE_CHECK; attempt++){
+                int a = unidom::random_in_range(0, points.size()-1);
+                int b = unidom::random_in_range(0, points.size()-1);
+                if (a != b && suitable(points[a],points[b])){
+                    i = a;
+                    j = b;
+                    break;
+                }
+            }
+            if (i < 0 && !any_suitable_pair(points,suitable))
+                return false;
+            if (i < 0)
+                continue;
+            int u = points[i], v = points[j];
+            adjacent[u][v] = adjacent[v][u] = true;
+            G[u].neighbours().push_back(v);
+            G[v].neighbours().push_back(u);
+            //Remove the higher position first so the other index stays valid
+            for(int idx: {max(i,j), min(i,j)}){
+                points[idx] = points.back();
+                points.pop_back();
+            }
+        }
+        return true;
+    }
+    template<typename F>
+    bool any_suitable_pair(vector<int>& points, F suitable){
+        for(unsigned int a = 0; a < points.size(); a++)
+            for(unsigned int b = a+1; b < points.size(); b++)
+                if (suitable(points[a],points[b]))
+                    return true;
+        return false;
+    }
+    int n;
+    int d;
+};
+REGISTER_INPUT_SOURCE( RandomRegularGenerator, "random_regular", "Generates a random d-regular graph: -n sets the number of vertices, -d the degree (use -count for multiple graphs).");
+
+
+/* Random Geometric Graph Generator */
+class GeometricGenerator: public RandomGraphGeneratorBase{
+public:
+    GeometricGenerator(){
+        ADD_PARAMETER(n);
+        ADD_PARAMETER(r);
+    }
+protected:
+    void generate(DominationInstance& inst){
+        check_vertex_count(n);
+        if (r < 0)
+            throw unidom::ConfigurableError("Parameter -r for generator \""+name()+"\" must be non-negative.");
+        Graph& G = inst.G;
+        //Points are placed uniformly in the unit square
+        vector<double> x(n), y(n);
+        for(int i = 0; i < n; i++){
+            x[i] = unidom::random_unit_interval();
+            y[i] = unidom::random_unit_interval();
+        }
+        G.reset(n);
+        for(int i = 0; i < n; i++){
+            for(int j = i+1; j < n; j++){
+                double dx = x[i]-x[j], dy = y[i]-y[j];
+                if (dx*dx + dy*dy <= r*r){
+                    G[i].neighbours().push_back(j);
+                    G[j].neighbours().push_back(i);
+                }
+            }
+        }
+    }
+private:
+    int n;
+    double r;
+};
+REGISTER_INPUT_SOURCE( GeometricGenerator, "geometric", "Generates a random geometric graph: -n points in the unit square, joined when within distance -r (use -count for multiple graphs).");
+
+
+/* Grid Graph Generator */
+class GridGenerator: public RandomGraphGeneratorBase{
+public:
+    GridGenerator(){
+        ADD_PARAMETER(rows);
+        ADD_PARAMETER(cols);
+        ADD_DOUBLE_PARAMETER_DEFAULT(p,1.0);
+    }
+protected:
+    void generate(DominationInstance& inst){
+        if (rows < 1 || cols < 1)
+            throw unidom::ConfigurableError("Parameters -rows and -cols for generator \""+name()+"\" must be at least 1.");
+        //Checked before multiplying, since rows*cols may overflow
+        if (rows > (unidom::MAX_VERTS-1)/cols)
+            throw unidom::ConfigurableError("Generator \""+name()+"\" requires -rows times -cols to be less than "+std::to_string(unidom::MAX_VERTS)+".");
+        check_vertex_count(rows*cols);
+        check_probability(p,"-p");
+        Graph& G = inst.G;
+        G.reset(rows*cols);
+        for(int i = 0; i < rows; i++){
+            for(int j = 0; j < cols; j++){
+                VertIndex v = i*cols + j;
+                if (j+1 < cols && keep_edge())
+                    G.add_edge_simple(v, v+1); //East neighbour
+                if (i+1 < rows && keep_edge())
+                    G.add_edge_simple(v, v+cols); //South neighbour
+            }
+        }
+        sort_neighbours(G);
+    }
+private:
+    bool keep_edge(){
+        //Avoid consuming random numbers for the ordinary (unperturbed) grid
+        return p >= 1.0 || unidom::random_unit_interval() < p;
+    }
+    int rows;
+    int cols;
+    double p;
+};
+REGISTER_INPUT_SOURCE( GridGenerator, "grid", "Generates a -rows by -cols grid graph, keeping each edge with probability -p (default 1) (use -count for multiple graphs).");
+
+
+
+
+
+
+
+
+
+
+
 
 
 
@@ -370,6 +710,12 @@ protected:
                 }
             }
         }
+        
+        //Every edge lies in exactly one upward-pointing triangle
+        inst.clique_cover.clear();
+        for(int i = 0; i < n-1; i++)
+            for (int j = 0; j <= i; j++)
+                inst.clique_cover.push_back({get_index(i,j), get_index(i+1,j), get_index(i+1,j+1)});
     }
 
 };
@@ -414,6 +760,21 @@ protected:
                 }
             }
         }
+        
+        //The lines in each of the three directions are cliques which cover all edges
+        inst.clique_cover.clear();
+        for(int i = 0; i < n; i++){
+            vector<VertIndex> row, column, diagonal;
+            for(int k = 0; k <= i; k++)
+                row.push_back(get_index(i,k));
+            for(int k = i; k < n; k++)
+                column.push_back(get_index(k,i));
+            for(int k = 0; i+k < n; k++)
+                diagonal.push_back(get_index(i+k,k));
+            for(auto& line: {row, column, diagonal})
+                if (line.size() > 1)
+                    inst.clique_cover.push_back(line);
+        }
     }
 };
 REGISTER_INPUT_SOURCE( HexrookGenerator, "hexrook", "Generates a Hex Rook Graph (use -n to set the order).");
@@ -0,0 +1,286 @@
+/*  lns_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include "unidom_common.hpp"
+#include "compound_solver.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+
+namespace{
+
+    const int NEIGHBOURHOOD_BFS = 0;
+    const int NEIGHBOURHOOD_RANDOM = 1;
+    const int NEIGHBOURHOOD_WINDOW = 2;
+
+    //Large neighbourhood search: starting from a greedy dominating set (or the incumbent
+    //set of the instance, if it is smaller), repeatedly free a region of the graph (a
+    //BFS ball around a random vertex, a random subset of vertices or a square window
+    //of a board graph), fix every other vertex as it
+    //is in the incumbent set (with force_in and force_out) and search the region with
+    //the base solver, limited to -node_limit nodes and to sets smaller than the
+    //incumbent. Each improvement is output as it is found. With -threads T, several
+    //regions are searched in parallel against the same incumbent. By default, sets
+    //of the same size as the incumbent also replace it (but are not output), which
+    //lets the search move across plateaus (use -nosideways to only accept improvements).
+    //The result is usually not a minimum dominating set (and is never proven to be).
+    class LNSSolver: public CompoundSolverBase{
+    public:
+        LNSSolver(): CompoundSolverBase("DD"){
+            iterations = 1000;
+            region_size = 40;
+            node_limit = 20000;
+            num_threads = 1;
+            neighbourhood = NEIGHBOURHOOD_BFS;
+            sideways = true;
+        }
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-iterations")
+                iterations = parser.get_next_unsigned_int();
+            else if (arg == "-region_size")
+                region_size = parser.get_next_unsigned_int();
+            else if (arg == "-node_limit")
+                node_limit = parser.get_next_unsigned_int();
+            else if (arg == "-sideways")
+                sideways = true;
+            else if (arg == "-nosideways")
+                sideways = false;
+            else if (arg == "-threads"){
+                num_threads = parser.get_next_unsigned_int();
+                if (num_threads == 0)
+                    throw unidom::ConfigurableError("Parameter -threads must be at least 1.");
+            }else if (arg == "-neighbourhood"){
+                string type = parser.get_next_string();
+                if (type == "bfs")
+                    neighbourhood = NEIGHBOURHOOD_BFS;
+                else if (type == "random")
+                    neighbourhood = NEIGHBOURHOOD_RANDOM;
+                else if (type == "window")
+                    neighbourhood = NEIGHBOURHOOD_WINDOW;
+                else
+                    throw unidom::ConfigurableError("Unknown neighbourhood type \""+type+"\" (use bfs, random or window).");
+            }else
+                return CompoundSolverBase::accept_argument(arg,parser);
+            return true;
+        }
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            if (base_generates_all())
+                throw unidom::ConfigurableError("The lns solver requires an optimizing base solver.");
+            if (neighbourhood == NEIGHBOURHOOD_WINDOW)
+                check_board(inst.G);
+
+            output_proxy.initialize(inst);
+            if (!greedy_dominating_set(inst, incumbent)){
+                unidom::log << "No dominating set exists" << std::endl;
+                output_proxy.finalize(inst);
+                return;
+            }
+            unidom::log << "Initial (greedy) set size: " << incumbent.get_size() << std::endl;
+            if (inst.incumbent.get_size() > 0 && inst.incumbent.get_size() < incumbent.get_size() && unidom::is_dominating_set(inst,inst.incumbent)){
+                incumbent = inst.incumbent;
+                unidom::log << "Starting from the incumbent of the instance (size " << incumbent.get_size() << ")" << std::endl;
+            }
+            output_proxy.process_set(inst,incumbent);
+
+            vector<unsigned int> seeds;
+            for(unsigned int i = 0; i < num_threads; i++)
+                seeds.push_back(unidom::random_in_range(0,1000000000));
+
+            improvements = 0;
+            std::atomic<unsigned int> next_iteration(0);
+            vector<std::exception_ptr> errors(num_threads);
+            vector<std::thread> workers;
+            for(unsigned int i = 0; i < num_threads; i++){
+                workers.emplace_back([&,i](){
+                    try{
+                        run_worker(seeds[i], inst, next_iteration, output_proxy);
+                    }catch(...){
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for(auto& worker: workers)
+                worker.join();
+            for(auto& error: errors)
+                if (error)
+                    std::rethrow_exception(error);
+
+            unidom::log << iterations << " iterations, " << improvements << " improvements, final size " << incumbent.get_size() << std::endl;
+            output_proxy.finalize(inst);
+        }
+    private:
+        unsigned int iterations;
+        unsigned int region_size;
+        unsigned int node_limit;
+        unsigned int num_threads;
+        int neighbourhood;
+        bool sideways;
+        int board_size;
+
+        //Shared between the worker threads (protected by incumbent_mutex)
+        VertexSet incumbent;
+        unsigned int improvements;
+        std::mutex incumbent_mutex;
+
+        void check_board(Graph& G){
+            int n = G.n();
+            board_size = (int)std::lround(std::sqrt((double)n));
+            bool valid = board_size*board_size == n;
+            for(int v = 0; valid && v < n; v++)
+                if (G[v].get_real_index() < 0 || G[v].get_real_index() >= n)
+                    valid = false;
+            if (!valid)
+                throw unidom::ConfigurableError("The window neighbourhood requires an n x n board graph.");
+        }
+
+        //Repeatedly add the allowed vertex which dominates the most undominated vertices.
+        //Returns false if some vertex cannot be dominated.
+        bool greedy_dominating_set(DominationInstance& inst, VertexSet& S){
+            Graph& G = inst.G;
+            int n = G.n();
+            vector<int> covered(n,0);
+            int total_covered = 0;
+            auto add = [&](VertIndex v){
+                S.add(v);
+                if (!covered[v]++)
+                    total_covered++;
+                for(VertIndex u: G[v].neighbours())
+                    if (!covered[u]++)
+                        total_covered++;
+            };
+            S.reset_empty();
+            for(VertIndex v: inst.force_in)
+                add(v);
+            while(total_covered < n){
+                VertIndex best_vertex = Graph::INVALID_VERTEX;
+                int best_gain = 0;
+                for(VertIndex v = 0; v < n; v++){
+                    if (S.contains(v) || inst.force_out.contains(v))
+                        continue;
+                    int gain = covered[v]? 0 : 1;
+                    for(VertIndex u: G[v].neighbours())
+                        if (!covered[u])
+                            gain++;
+                    if (gain > best_gain){
+                        best_gain = gain;
+                        best_vertex = v;
+                    }
+                }
+                if (best_vertex == Graph::INVALID_VERTEX)
+                    return false;
+                add(best_vertex);
+            }
+            return true;
+        }
+
+        vector<char> choose_region(Graph& G, std::mt19937& rng){
+            int n = G.n();
+            vector<char> in_region(n,0);
+            int size = std::min((int)region_size, n);
+            if (neighbourhood == NEIGHBOURHOOD_BFS){
+                vector<VertIndex> queue;
+                queue.push_back(rng()%n);
+                in_region[queue[0]] = 1;
+                for(unsigned int i = 0; i < queue.size() && (int)queue.size() < size; i++)
+                    for(VertIndex u: G[queue[i]].neighbours())
+                        if (!in_region[u] && (int)queue.size() < size){
+                            in_region[u] = 1;
+                            queue.push_back(u);
+                        }
+            }else if (neighbourhood == NEIGHBOURHOOD_RANDOM){
+                vector<VertIndex> vertices(n);
+                for(int v = 0; v < n; v++)
+                    vertices[v] = v;
+                std::shuffle(vertices.begin(), vertices.end(), rng);
+                for(int i = 0; i < size; i++)
+                    in_region[vertices[i]] = 1;
+            }else{
+                int width = std::min(board_size, (int)std::ceil(std::sqrt((double)size)));
+                int top = rng()%(board_size-width+1);
+                int left = rng()%(board_size-width+1);
+                for(int v = 0; v < n; v++){
+                    int cell = G[v].get_real_index();
+                    int row = cell/board_size, col = cell%board_size;
+                    if (row >= top && row < top+width && col >= left && col < left+width)
+                        in_region[v] = 1;
+                }
+            }
+            return in_region;
+        }
+
+        void run_worker(unsigned int seed, DominationInstance& inst, std::atomic<unsigned int>& next_iteration, OutputProxy& output_proxy){
+            std::mt19937 rng(seed);
+            int n = inst.G.n();
+            unidom::SolverPtr solver = spawn_base_solver({"-node_limit", std::to_string(node_limit)});
+            while(next_iteration++ < iterations){
+                VertexSet current;
+                {
+                    std::lock_guard<std::mutex> lock(incumbent_mutex);
+                    current = incumbent;
+                }
+                vector<char> in_region = choose_region(inst.G, rng);
+                DominationInstance region_inst = inst;
+                region_inst.incumbent.reset_empty();
+                for(VertIndex v = 0; v < n; v++){
+                    if (in_region[v] || region_inst.force_in.contains(v) || region_inst.force_out.contains(v))
+                        continue;
+                    if (current.contains(v))
+                        region_inst.force_in.add(v);
+                    else
+                        region_inst.force_out.add(v);
+                }
+                int size_limit = sideways? current.get_size() : current.get_size()-1;
+                unidom::ListArgumentTokenizer bound_arguments({"-u", std::to_string(size_limit)});
+                solver->parse_arguments(bound_arguments);
+
+                BestSetCaptureProxy capture;
+                solver->solve(region_inst, capture);
+                if (!capture.found)
+                    continue;
+
+                std::lock_guard<std::mutex> lock(incumbent_mutex);
+                if (capture.best_set.get_size() < incumbent.get_size()){
+                    incumbent = capture.best_set;
+                    improvements++;
+                    output_proxy.process_set(inst,incumbent);
+                }else if (sideways && capture.best_set.get_size() == incumbent.get_size())
+                    incumbent = capture.best_set;
+            }
+        }
+    };
+
+}
+
+REGISTER_SOLVER( LNSSolver, "lns", "Large neighbourhood search: re-optimize regions (-neighbourhood bfs/random/window, -region_size S) of the incumbent with a node-limited base solver (-base NAME args...) for -iterations K, in -threads T" );
@@ -20,10 +20,15 @@
 
 #include <vector>
 #include <string>
+#include <fstream>
+#include <memory>
 #include "graph.hpp"
 #include "graph_util.hpp"
 #include "unidom_common.hpp"
 #include "unidom_util.hpp"
+#include "unidom_telemetry.hpp"
+#include "result_cache.hpp"
+#include "unidom_alloc_tracking.hpp"
 
 using std::string;
 
@@ -58,19 +63,85 @@ int main(int argc, char** argv){
     
     unidom::Timer solver_timer;
     
+    bool use_telemetry = C.telemetry_file != "";
+    std::ofstream telemetry_file_stream;
+    if (use_telemetry && C.telemetry_file != "-"){
+        telemetry_file_stream.open(C.telemetry_file, std::ios_base::app);
+        if (!telemetry_file_stream){
+            unidom::log << "Unable to open telemetry file \"" << C.telemetry_file << "\"" << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& telemetry_out = (C.telemetry_file == "-")? unidom::log : telemetry_file_stream;
+    unidom::PipelineTelemetry telemetry;
+    unidom::TelemetryOutputProxy telemetry_proxy(*C.output_proxy, telemetry);
+    unidom::OutputProxy& output_proxy = use_telemetry? telemetry_proxy : *C.output_proxy;
+    
+    std::unique_ptr<unidom::ResultCache> result_cache;
+    if (C.result_cache_directory != "")
+        result_cache = std::make_unique<unidom::ResultCache>(C.result_cache_directory);
+    unidom::ResultCaptureOutputProxy capture_proxy(output_proxy);
+    
     while(1){
         unidom::DominationInstance inst;
+        if (use_telemetry){
+            telemetry.begin_instance();
+            telemetry.start_phase("input");
+        }
         if (!C.input_source->read_next(inst))
             break;
         C.original_input_graph = inst.G;
+        if (use_telemetry)
+            telemetry.start_phase("preprocess");
         for(auto F: C.preprocess_filters)
             F->process(inst);
         //TODO add a consistency check for the graph and the force_in/force_out sets
+        if (use_telemetry)
+            telemetry.start_phase("solve");
         solver_timer.start();
-        C.solver->solve(inst, *C.output_proxy);
+        //Every result passes through capture_proxy, so that the best set can be cached and
+        //remembered for the next instance
+        capture_proxy.found = false;
+        bool result_optimal = false;
+        if (result_cache && C.solver->result_is_cacheable()){
+            //Instances isomorphic to a previously solved one are answered from the cache
+            //(only when any minimum dominating set is a correct output of the solver)
+            unidom::CanonicalForm form = unidom::canonical_form(inst);
+            VertexSet cached_set;
+            if (result_cache->lookup(form, inst, cached_set)){
+                unidom::log << "Result cache hit (size " << cached_set.get_size() << ")" << std::endl;
+                capture_proxy.initialize(inst);
+                capture_proxy.process_set(inst, cached_set);
+                capture_proxy.finalize(inst);
+                result_optimal = true;
+            }else{
+                C.solver->solve(inst, capture_proxy);
+                result_optimal = capture_proxy.found && C.solver->result_is_optimal();
+                if (result_optimal)
+                    result_cache->store(form, capture_proxy.best_set);
+            }
+        }else{
+            C.solver->solve(inst, capture_proxy);
+            result_optimal = capture_proxy.found && C.solver->result_is_optimal();
+        }
+        C.previous_result.clear();
+        if (capture_proxy.found)
+            for(VertIndex v: capture_proxy.best_set)
+                C.previous_result.push_back(inst.G[v].get_real_index());
+        //A minimum set under force_in/force_out constraints only bounds the unconstrained
+        //domination number from above, so only unconstrained optima are kept as bounds
+        bool unconstrained = inst.force_in.get_size() == 0 && inst.force_out.get_size() == 0;
+        C.previous_lower_bound = inst.lower_bound_hint;
+        if (result_optimal && unconstrained)
+            C.previous_lower_bound = capture_proxy.best_set.get_size();
         solver_timer.stop();
         unidom::log << "Total Solver Time: " << solver_timer.elapsed_seconds() << std::endl;
+        if (use_telemetry)
+            telemetry.write_json(telemetry_out, C);
     }
     
+    //In allocation tracking builds, signal any allocations in the search with the exit status
+    if (unidom::hot_path_allocations_detected())
+        return 1;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+/*  parallel_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <sched.h>
+#include "unidom_common.hpp"
+#include "compound_solver.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+using unidom::SolutionBatch;
+
+namespace{
+
+    //Serializes the output of several worker threads into a single output proxy.
+    //The workers' calls to initialize() and finalize() are ignored, since the
+    //parallel solver calls them once on the real output proxy.
+    //When the base solver is optimizing, only sets smaller than every set
+    //already output are passed on.
+    class SynchronizedOutputProxy: public OutputProxy{
+    public:
+        SynchronizedOutputProxy(OutputProxy& proxy, bool only_improving, int initial_best):
+            inner(proxy), only_improving(only_improving), best_size(initial_best) {}
+        string name(){
+            return inner.name();
+        }
+        string description(){
+            return inner.description();
+        }
+        void process_set(DominationInstance& inst, VertexSet& dominating_set){
+            std::lock_guard<std::mutex> lock(output_mutex);
+            if (only_improving){
+                if (dominating_set.get_size() >= best_size)
+                    return;
+                best_size = dominating_set.get_size();
+            }
+            inner.process_set(inst,dominating_set);
+        }
+        void process_batch(DominationInstance& inst, SolutionBatch& batch){
+            if (only_improving){
+                //Filter set by set (process_set takes the lock)
+                OutputProxy::process_batch(inst,batch);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(output_mutex);
+            inner.process_batch(inst,batch);
+        }
+        int get_best_size(){
+            std::lock_guard<std::mutex> lock(output_mutex);
+            return best_size;
+        }
+    private:
+        OutputProxy& inner;
+        bool only_improving;
+        int best_size;
+        std::mutex output_mutex;
+    };
+
+    //A subtree of the search, given by the vertices forced into and out of the set.
+    struct Subproblem{
+        vector<VertIndex> in, out;
+    };
+
+    //Splits the search into subproblems (by branching on the closed neighbourhood
+    //of an undominated vertex up to -split_depth times), which worker threads then
+    //solve with the base solver in parallel. Every dominating set belongs to
+    //exactly one subproblem, so both optimizing and _all base solvers can be used.
+    //With -pin, each worker is bound to one of the CPUs available to the process.
+    //Each worker copies the instance and creates its solver from inside its own
+    //thread, so the solver state and the graph are first touched (and therefore
+    //placed by the kernel) on the memory node of the CPU running the worker.
+    class ParallelSolver: public CompoundSolverBase{
+    public:
+        ParallelSolver(): CompoundSolverBase("DD"){
+            num_threads = std::thread::hardware_concurrency();
+            if (num_threads == 0)
+                num_threads = 1;
+            split_depth = 1;
+            pin_threads = false;
+        }
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-threads"){
+                num_threads = parser.get_next_unsigned_int();
+                if (num_threads == 0)
+                    throw unidom::ConfigurableError("Parameter -threads must be at least 1.");
+            }else if (arg == "-split_depth")
+                split_depth = parser.get_next_unsigned_int();
+            else if (arg == "-pin")
+                pin_threads = true;
+            else if (arg == "-nopin")
+                pin_threads = false;
+            else
+                return CompoundSolverBase::accept_argument(arg,parser);
+            return true;
+        }
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            int n = inst.G.n();
+            vector<Subproblem> subproblems = split_instance(inst);
+            unidom::log << "Split into " << subproblems.size() << " subproblems" << std::endl;
+
+            vector<int> cpus = available_cpus();
+            bool optimizing = !base_generates_all();
+            SynchronizedOutputProxy shared_proxy(output_proxy, optimizing, n+1);
+
+            vector<WorkerResult> results(num_threads);
+            vector<std::exception_ptr> errors(num_threads);
+            vector<std::thread> workers;
+            std::atomic<unsigned int> next_subproblem(0);
+
+            output_proxy.initialize(inst);
+            for(unsigned int i = 0; i < num_threads; i++){
+                int cpu = (pin_threads && cpus.size() > 0)? cpus[i%cpus.size()] : -1;
+                workers.emplace_back([&,i,cpu](){
+                    try{
+                        run_worker(i, cpu, inst, subproblems, next_subproblem, shared_proxy, results[i]);
+                    }catch(...){
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for(auto& worker: workers)
+                worker.join();
+            for(auto& error: errors)
+                if (error)
+                    std::rethrow_exception(error);
+
+            unsigned long long total_nodes = 0;
+            for(unsigned int i = 0; i < num_threads; i++){
+                WorkerResult& R = results[i];
+                unidom::log << "Thread " << i;
+                if (R.cpu >= 0)
+                    unidom::log << " (CPU " << R.cpu << ")";
+                unidom::log << ": " << R.subproblems << " subproblems, " << R.nodes << " nodes in " << R.seconds << " seconds";
+                if (R.seconds > 0)
+                    unidom::log << " (" << (unsigned long long)(R.nodes/R.seconds) << " nodes/second)";
+                unidom::log << std::endl;
+                total_nodes += R.nodes;
+            }
+            unidom::log << "Total nodes (all threads): " << total_nodes << std::endl;
+            output_proxy.finalize(inst);
+        }
+    private:
+        struct WorkerResult{
+            int cpu = -1;
+            unsigned int subproblems = 0;
+            unsigned long long nodes = 0;
+            double seconds = 0;
+        };
+
+        static constexpr char FREE = 0;
+        static constexpr char IN = 1;
+        static constexpr char OUT = 2;
+
+        unsigned int num_threads;
+        unsigned int split_depth;
+        bool pin_threads;
+
+        vector<Subproblem> split_instance(DominationInstance& inst){
+            Graph& G = inst.G;
+            int n = G.n();
+            vector<int> covered(n,0);
+            vector<char> state(n,FREE);
+            for(VertIndex v: inst.force_out)
+                state[v] = OUT;
+            for(VertIndex v: inst.force_in){
+                state[v] = IN;
+                set_coverage(G,covered,v,1);
+            }
+            vector<Subproblem> subproblems;
+            Subproblem current;
+            split(G,0,current,covered,state,subproblems);
+            return subproblems;
+        }
+
+        void set_coverage(Graph& G, vector<int>& covered, VertIndex v, int delta){
+            covered[v] += delta;
+            for(VertIndex u: G[v].neighbours())
+                covered[u] += delta;
+        }
+
+        void split(Graph& G, unsigned int depth, Subproblem& current, vector<int>& covered, vector<char>& state, vector<Subproblem>& subproblems){
+            if (depth == split_depth){
+                subproblems.push_back(current);
+                return;
+            }
+            //Branch on the undominated vertex with the fewest candidate dominators
+            int n = G.n();
+            VertIndex branch_vertex = Graph::INVALID_VERTEX;
+            int branch_candidates = n+1;
+            for(VertIndex v = 0; v < n; v++){
+                if (covered[v])
+                    continue;
+                int candidates = (state[v] == FREE)? 1 : 0;
+                for(VertIndex u: G[v].neighbours())
+                    if (state[u] == FREE)
+                        candidates++;
+                if (candidates < branch_candidates){
+                    branch_candidates = candidates;
+                    branch_vertex = v;
+                }
+            }
+            if (branch_vertex == Graph::INVALID_VERTEX){
+                //Already dominating
+                subproblems.push_back(current);
+                return;
+            }
+            if (branch_candidates == 0)
+                return;
+
+            vector<VertIndex> candidates;
+            if (state[branch_vertex] == FREE)
+                candidates.push_back(branch_vertex);
+            for(VertIndex u: G[branch_vertex].neighbours())
+                if (state[u] == FREE)
+                    candidates.push_back(u);
+            //Subproblem k contains candidate k and excludes candidates 0 to k-1
+            for(VertIndex u: candidates){
+                state[u] = IN;
+                current.in.push_back(u);
+                set_coverage(G,covered,u,1);
+                split(G,depth+1,current,covered,state,subproblems);
+                set_coverage(G,covered,u,-1);
+                current.in.pop_back();
+                state[u] = OUT;
+                current.out.push_back(u);
+            }
+            for(VertIndex u: candidates){
+                state[u] = FREE;
+                current.out.pop_back();
+            }
+        }
+
+        vector<int> available_cpus(){
+            vector<int> cpus;
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(mask), &mask) != 0)
+                return cpus;
+            for(int c = 0; c < CPU_SETSIZE; c++)
+                if (CPU_ISSET(c, &mask))
+                    cpus.push_back(c);
+            return cpus;
+        }
+
+        void run_worker(unsigned int index, int cpu, DominationInstance& inst, vector<Subproblem>& subproblems,
+                        std::atomic<unsigned int>& next_subproblem, SynchronizedOutputProxy& shared_proxy, WorkerResult& result){
+            if (cpu >= 0){
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                CPU_SET(cpu, &mask);
+                //A pid of 0 refers to the calling thread
+                if (sched_setaffinity(0, sizeof(mask), &mask) == 0)
+                    result.cpu = cpu;
+                else
+                    unidom::log << "Warning: Unable to pin thread " << index << " to CPU " << cpu << std::endl;
+            }
+            //Both the local copy of the instance and the solver are created after pinning
+            int n = inst.G.n();
+            DominationInstance local_inst = inst;
+            unidom::SolverPtr solver = spawn_base_solver(vector<string>());
+            bool optimizing = !base_generates_all();
+
+            auto start_time = std::chrono::steady_clock::now();
+            while(1){
+                unsigned int k = next_subproblem++;
+                if (k >= subproblems.size())
+                    break;
+                Subproblem& P = subproblems[k];
+                if (optimizing){
+                    //Only look for sets smaller than the best one found by any thread
+                    int best_size = shared_proxy.get_best_size();
+                    if (local_inst.force_in.get_size() + (int)P.in.size() >= best_size)
+                        continue;
+                    if (best_size <= n){
+                        unidom::ListArgumentTokenizer bound_arguments({"-u", std::to_string(best_size-1)});
+                        solver->parse_arguments(bound_arguments);
+                    }
+                }
+                DominationInstance subproblem_inst = local_inst;
+                for(VertIndex v: P.in)
+                    subproblem_inst.force_in.add(v);
+                for(VertIndex v: P.out)
+                    subproblem_inst.force_out.add(v);
+                solver->solve(subproblem_inst, shared_proxy);
+                result.subproblems++;
+                result.nodes += solver->search_node_count();
+            }
+            auto end_time = std::chrono::steady_clock::now();
+            result.seconds = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count()/1000000.0;
+        }
+    };
+
+}
+
+REGISTER_SOLVER( ParallelSolver, "parallel", "Split the search into subproblems (to depth -split_depth D) and solve them with a base solver (-base NAME args...) in -threads T threads (-pin binds each thread to a CPU)" );
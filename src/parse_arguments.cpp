@@ -100,10 +100,11 @@ private:
 
 bool is_root_argument(string s){
     string s2 = s.substr(0,2);
-    return s == "-seed" || s == "-h" || s == "-help" || s2 == "-I" || s2 == "-S" || s2 == "-F" || s2 == "-O";
+    return s == "-seed" || s == "-h" || s == "-help" || s == "-telemetry" || s == "-cache" || s2 == "-I" || s2 == "-S" || s2 == "-F" || s2 == "-O";
 }
 
-void stack_argument_parse(StackedArgumentTokenizer& S, unidom::Configurable& component){
+//Returns the list of arguments passed to the component
+vector<string> stack_argument_parse(StackedArgumentTokenizer& S, unidom::Configurable& component){
     vector<string> sub_args;
     while(S.has_next() && !is_root_argument(S.peek_next_string()))
         sub_args.push_back(S.get_next_string());
@@ -113,6 +114,7 @@ void stack_argument_parse(StackedArgumentTokenizer& S, unidom::Configurable& com
         int sub_index = std::max(0,sub_tokenizer.get_current_idx()-1);
         throw ArgumentParsingException("Invalid argument \""+sub_args[sub_index]+"\"",abs_index);
     }
+    return sub_args;
 }
 
 
@@ -125,6 +127,10 @@ bool parse_arguments(unidom::SolverContext& C, std::vector<string> args){
             if (s == "-seed"){
                 unsigned int seed = S.get_next_int();
                 unidom::set_random_seed(seed);
+            }else if (s == "-telemetry"){
+                C.telemetry_file = S.get_next_string();
+            }else if (s == "-cache"){
+                C.result_cache_directory = S.get_next_string();
             }else if (s == "-help" || s == "-h"){
                 unidom::describe_components();
                 return false;
@@ -139,7 +145,7 @@ bool parse_arguments(unidom::SolverContext& C, std::vector<string> args){
                     unidom::log << "Invalid input source \""<<name<<"\""<<std::endl;
                     return false;
                 }
-                stack_argument_parse(S, *C.input_source);
+                C.input_source_arguments = stack_argument_parse(S, *C.input_source);
                 C.input_source->set_solver_context(C);
             }else if (s2 == "-S"){
                 string name = S.get_next_string();
@@ -152,7 +158,7 @@ bool parse_arguments(unidom::SolverContext& C, std::vector<string> args){
                     unidom::log << "Invalid solver \""<<name<<"\""<<std::endl;
                     return false;
                 }
-                stack_argument_parse(S, *C.solver);
+                C.solver_arguments = stack_argument_parse(S, *C.solver);
                 C.solver->set_solver_context(C);
             }else if (s2 == "-F"){
                 string name = S.get_next_string();
@@ -162,7 +168,7 @@ bool parse_arguments(unidom::SolverContext& C, std::vector<string> args){
                     return false;
                 }
                 C.preprocess_filters.push_back(filter);
-                stack_argument_parse(S, *filter);
+                C.preprocess_filter_arguments.push_back(stack_argument_parse(S, *filter));
                 filter->set_solver_context(C);
             }else if (s2 == "-O"){
                 string name = S.get_next_string();
@@ -175,7 +181,7 @@ bool parse_arguments(unidom::SolverContext& C, std::vector<string> args){
                     unidom::log << "Invalid output proxy \""<<name<<"\""<<std::endl;
                     return false;
                 }
-                stack_argument_parse(S, *C.output_proxy);
+                C.output_proxy_arguments = stack_argument_parse(S, *C.output_proxy);
                 C.output_proxy->set_solver_context(C);
             }else{
                 throw ArgumentParsingException("Invalid argument \""+s+"\"",S.get_absolute_idx());
@@ -115,6 +115,28 @@ public:
             if (v.deg() >= unidom::MAX_DEGREE)
                 throw unidom::ConfigurableError("Degree of queen graph exceeds MAX_DEGREE");
         
+        //Every row, column and diagonal is a clique, and together they cover all edges
+        inst.clique_cover.clear();
+        auto add_line = [&inst,n](int row, int col, int drow, int dcol){
+            std::vector<VertIndex> line;
+            for(; row >= 0 && row < n && col >= 0 && col < n; row += drow, col += dcol)
+                line.push_back(row*n + col);
+            if (line.size() > 1)
+                inst.clique_cover.push_back(line);
+        };
+        for(int i = 0; i < n; i++){
+            add_line(i,0,0,1); //Row i
+            add_line(0,i,1,0); //Column i
+        }
+        for(int i = 0; i < n; i++){
+            add_line(0,i,1,1); //Forward diagonals starting in row 0
+            add_line(0,i,1,-1); //Backward diagonals starting in row 0
+        }
+        for(int i = 1; i < n; i++){
+            add_line(i,0,1,1); //Forward diagonals starting in column 0
+            add_line(i,n-1,1,-1); //Backward diagonals starting in column n-1
+        }
+        
         return true;
     }
 public:	
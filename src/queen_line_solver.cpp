@@ -0,0 +1,77 @@
+/*  queen_line_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include "unidom_common.hpp"
+#include "bbt_line_cover.hpp"
+#include "graph_util.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::DominationInstance;
+
+
+//The queen_lines solvers run the line cover search (see bbt_line_cover.hpp) on
+//the 6n-2 lines of Queen(n) (rows, columns and both diagonal directions), for
+//queen graphs and all of their restricted variants (which only differ in their
+//force_in/force_out sets). The lines are placed using the real vertex indices,
+//and must form an edge clique cover of the graph, so the graph is exactly Queen(n).
+//Unlike CC, this does not depend on the instance carrying the cover of the board.
+struct QueenBoardLines: public LineCoverPolicy{
+    static const int LINES_PER_VERTEX = 4;
+
+    bool build(DominationInstance& inst, CliqueCover& lines){
+        Graph& G = inst.G;
+        int n = G.n();
+        int k = (int)std::lround(std::sqrt((double)n));
+        if (k*k != n)
+            return false;
+
+        vector<VertIndex> vertex_of_cell(n,(VertIndex)Graph::INVALID_VERTEX);
+        for(VertIndex v = 0; v < n; v++){
+            int c = G[v].get_real_index();
+            if (c < 0 || c >= n || vertex_of_cell[c] != Graph::INVALID_VERTEX)
+                return false;
+            vertex_of_cell[c] = v;
+        }
+
+        lines.assign(6*k-2,vector<VertIndex>());
+        for(int c = 0; c < n; c++){
+            int row = c/k, col = c%k;
+            for(int l: {row, k+col, 2*k+(row-col+k-1), 4*k-1+(row+col)})
+                lines[l].push_back(vertex_of_cell[c]);
+        }
+        return is_clique_cover(G,lines);
+    }
+    static string requirement(){
+        return "a queen graph";
+    }
+};
+
+
+namespace{
+    typedef LineCoverSolver<QueenBoardLines,false> QueenLines;
+    typedef LineCoverSolver<QueenBoardLines,true> QueenLines_all;
+}
+REGISTER_SOLVER( QueenLines, "queen_lines", "Line-occupancy DD solver for queen graphs and their restricted variants (optimization)");
+REGISTER_SOLVER( QueenLines_all, "queen_lines_all", "Line-occupancy DD solver for queen graphs and their restricted variants (generation)");
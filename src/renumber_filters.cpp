@@ -54,6 +54,23 @@ class RenumberFilter: public PreprocessFilter{
         
         for(VertIndex v: inst.force_out)
             new_inst.force_out.add( inverse_perm[v] );
+        
+        for(auto& clique: inst.clique_cover){
+            new_inst.clique_cover.push_back(vector<VertIndex>());
+            for(VertIndex v: clique)
+                new_inst.clique_cover.back().push_back( inverse_perm[v] );
+        }
+        
+        for(VertIndex v: inst.incumbent)
+            new_inst.incumbent.add( inverse_perm[v] );
+        new_inst.lower_bound_hint = inst.lower_bound_hint;
+        
+        //Conjugate each automorphism by the renumbering
+        for(auto& p: inst.automorphism_generators){
+            new_inst.automorphism_generators.push_back(vector<VertIndex>(n));
+            for(unsigned int i = 0; i < n; i++)
+                new_inst.automorphism_generators.back()[i] = inverse_perm[p[permuted_numbering[i]]];
+        }
         inst = new_inst;
         
     }
@@ -0,0 +1,286 @@
+/*  result_cache.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "unidom_common.hpp"
+#include "result_cache.hpp"
+
+using std::string;
+using std::vector;
+
+using namespace unidom;
+
+namespace{
+
+    typedef vector<int> Colouring;
+
+    const int FREE_VERTEX = 0;
+    const int FORCED_IN_VERTEX = 1;
+    const int FORCED_OUT_VERTEX = 2;
+
+    //Replace each colour by its rank among the distinct colours (so colour
+    //values do not depend on the vertex numbering). Returns the number of colours.
+    int normalize(Colouring& colour){
+        Colouring values = colour;
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        for(int& c: colour)
+            c = std::lower_bound(values.begin(), values.end(), c) - values.begin();
+        return values.size();
+    }
+
+    //Colour refinement: split colour classes by the multiset of colours in each
+    //vertex's neighbourhood until no class splits. Returns the number of colours.
+    int refine(Graph& G, Colouring& colour){
+        int n = G.n();
+        int num_colours = normalize(colour);
+        vector< vector<int> > signature(n);
+        vector<int> order(n);
+        while(num_colours < n){
+            for(int v = 0; v < n; v++){
+                signature[v].clear();
+                signature[v].push_back(colour[v]);
+                for(VertIndex u: G[v].neighbours())
+                    signature[v].push_back(colour[u]);
+                std::sort(signature[v].begin()+1, signature[v].end());
+                order[v] = v;
+            }
+            std::sort(order.begin(), order.end(), [&signature](int a, int b){
+                return signature[a] < signature[b];
+            });
+            int new_colours = 0;
+            for(int i = 0; i < n; i++){
+                if (i > 0 && signature[order[i]] != signature[order[i-1]])
+                    new_colours++;
+                colour[order[i]] = new_colours;
+            }
+            new_colours++;
+            if (new_colours == num_colours)
+                break;
+            num_colours = new_colours;
+        }
+        return num_colours;
+    }
+
+    class CanonicalSearch{
+    public:
+        CanonicalSearch(Graph& G, Colouring& vertex_type, unsigned int leaf_limit):
+            G(G), vertex_type(vertex_type), leaf_limit(leaf_limit), leaves(0), found(false) {}
+
+        void search(Colouring colour){
+            if (leaves >= leaf_limit)
+                return;
+            int n = G.n();
+            int num_colours = refine(G,colour);
+            if (num_colours == n){
+                leaves++;
+                vector<int> certificate = encode(colour);
+                if (!found || certificate < best_certificate){
+                    best_certificate = certificate;
+                    best_labelling = colour;
+                    found = true;
+                }
+                return;
+            }
+            //Individualize each vertex of the smallest non-singleton class in turn
+            vector<int> class_size(num_colours,0);
+            for(int c: colour)
+                class_size[c]++;
+            int target = -1;
+            for(int c = 0; c < num_colours; c++)
+                if (class_size[c] > 1 && (target == -1 || class_size[c] < class_size[target]))
+                    target = c;
+            for(int v = 0; v < n; v++){
+                if (colour[v] != target)
+                    continue;
+                Colouring individualized(n);
+                for(int u = 0; u < n; u++)
+                    individualized[u] = 2*colour[u]+1;
+                individualized[v] = 2*colour[v];
+                search(individualized);
+            }
+        }
+
+        bool complete(){
+            return leaves < leaf_limit;
+        }
+
+        Graph& G;
+        Colouring& vertex_type;
+        unsigned int leaf_limit, leaves;
+        bool found;
+        vector<int> best_certificate;
+        Colouring best_labelling;
+    private:
+        //The instance relabelled by a discrete colouring: for each label in order,
+        //the type of the vertex, its degree and the sorted labels of its neighbours.
+        vector<int> encode(Colouring& label){
+            int n = G.n();
+            vector<int> vertex_of_label(n);
+            for(int v = 0; v < n; v++)
+                vertex_of_label[label[v]] = v;
+            vector<int> certificate;
+            vector<int> neighbour_labels;
+            for(int i = 0; i < n; i++){
+                int v = vertex_of_label[i];
+                neighbour_labels.clear();
+                for(VertIndex u: G[v].neighbours())
+                    neighbour_labels.push_back(label[u]);
+                std::sort(neighbour_labels.begin(), neighbour_labels.end());
+                certificate.push_back(vertex_type[v]);
+                certificate.push_back(neighbour_labels.size());
+                certificate.insert(certificate.end(), neighbour_labels.begin(), neighbour_labels.end());
+            }
+            return certificate;
+        }
+    };
+
+    unsigned long long fnv1a_hash(const string& s){
+        unsigned long long hash = 14695981039346656037ull;
+        for(unsigned char c: s){
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+}
+
+CanonicalForm unidom::canonical_form(DominationInstance& inst, unsigned int leaf_limit){
+    Graph& G = inst.G;
+    int n = G.n();
+    Colouring vertex_type(n,FREE_VERTEX);
+    for(VertIndex v: inst.force_in)
+        vertex_type[v] = FORCED_IN_VERTEX;
+    for(VertIndex v: inst.force_out)
+        vertex_type[v] = FORCED_OUT_VERTEX;
+
+    CanonicalSearch S(G, vertex_type, leaf_limit);
+    S.search(vertex_type);
+
+    CanonicalForm form;
+    form.canonical = S.complete();
+    form.label.assign(S.best_labelling.begin(), S.best_labelling.end());
+    std::ostringstream key;
+    key << n;
+    for(int x: S.best_certificate)
+        key << " " << x;
+    form.key = key.str();
+    return form;
+}
+
+unidom::ResultCache::ResultCache(string directory): directory(directory){
+    if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+        throw ConfigurableError("Unable to create cache directory \""+directory+"\".");
+}
+
+string unidom::ResultCache::entry_path(CanonicalForm& form){
+    char hash_string[17];
+    std::snprintf(hash_string, sizeof(hash_string), "%016llx", fnv1a_hash(form.key));
+    return directory + "/" + hash_string + ".entry";
+}
+
+//Returns a file descriptor holding the lock (closing it releases the lock), or -1 on failure.
+int unidom::ResultCache::lock(int operation){
+    string lock_path = directory + "/.lock";
+    int fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0)
+        return -1;
+    if (flock(fd, operation) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+//Each entry holds the key on its first line, and the size and vertex labels of
+//the set on the second.
+bool unidom::ResultCache::lookup(CanonicalForm& form, DominationInstance& inst, VertexSet& result){
+    int lock_fd = lock(LOCK_SH);
+    if (lock_fd < 0){
+        log << "Unable to lock the result cache" << std::endl;
+        return false;
+    }
+    std::ifstream entry(entry_path(form));
+    string key, set_line;
+    bool valid = entry && std::getline(entry,key) && std::getline(entry,set_line) && key == form.key;
+    close(lock_fd);
+    if (!valid)
+        return false;
+
+    int n = inst.G.n();
+    vector<VertIndex> vertex_of_label(n);
+    for(int v = 0; v < n; v++)
+        vertex_of_label[form.label[v]] = v;
+    std::istringstream set_stream(set_line);
+    int size = -1;
+    set_stream >> size;
+    result.reset_empty();
+    for(int i = 0; i < size; i++){
+        int label = -1;
+        if (!(set_stream >> label) || label < 0 || label >= n){
+            log << "Ignoring corrupted cache entry " << entry_path(form) << std::endl;
+            return false;
+        }
+        result.add(vertex_of_label[label]);
+    }
+    if (size < 0 || !is_dominating_set(inst,result)){
+        log << "Ignoring invalid cache entry " << entry_path(form) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void unidom::ResultCache::store(CanonicalForm& form, VertexSet& dominating_set){
+    int lock_fd = lock(LOCK_EX);
+    if (lock_fd < 0){
+        log << "Unable to lock the result cache" << std::endl;
+        return;
+    }
+    string path = entry_path(form);
+    string temp_path = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream entry(temp_path);
+        entry << form.key << std::endl;
+        entry << dominating_set.get_size();
+        vector<int> labels;
+        for(VertIndex v: dominating_set)
+            labels.push_back(form.label[v]);
+        std::sort(labels.begin(), labels.end());
+        for(int label: labels)
+            entry << " " << label;
+        entry << std::endl;
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0){
+        log << "Unable to write cache entry " << path << std::endl;
+        std::remove(temp_path.c_str());
+    }
+    close(lock_fd);
+}
@@ -0,0 +1,106 @@
+/*  result_cache.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <string>
+#include <vector>
+#include "unidom_common.hpp"
+
+namespace unidom{
+
+    //A canonical labelling of a domination instance (the graph, with each vertex
+    //coloured by whether it is in force_in, force_out or neither).
+    struct CanonicalForm{
+        //Complete description of the relabelled instance, so equal keys always
+        //mean isomorphic instances
+        std::string key;
+        std::vector<VertIndex> label; //label[v] is the canonical label of vertex v
+        //False if the search was cut off by the leaf limit. The key is still valid,
+        //but isomorphic instances numbered differently may get different keys.
+        bool canonical;
+    };
+
+    //Computed by colour refinement and individualization (without automorphism
+    //pruning), keeping the smallest encoding over at most leaf_limit leaves.
+    CanonicalForm canonical_form(DominationInstance& inst, unsigned int leaf_limit = 256);
+
+    //Minimum dominating sets stored on disk, one file per instance (named by
+    //a hash of the canonical key). Access is serialized between processes
+    //with flock on a lock file in the cache directory, and entries are written
+    //to a temporary file and then renamed, so readers never see partial entries.
+    class ResultCache{
+    public:
+        ResultCache(std::string directory);
+        //If the instance is in the cache, store its cached set (in the vertex
+        //indices of inst) in result and return true.
+        bool lookup(CanonicalForm& form, DominationInstance& inst, VertexSet& result);
+        //Add a minimum dominating set of the instance to the cache.
+        void store(CanonicalForm& form, VertexSet& dominating_set);
+    private:
+        std::string directory;
+        std::string entry_path(CanonicalForm& form);
+        int lock(int operation);
+    };
+
+    //Passes everything through to another output proxy, keeping a copy of the
+    //smallest set produced (so that it can be stored in the cache).
+    class ResultCaptureOutputProxy: public OutputProxy{
+    public:
+        ResultCaptureOutputProxy(OutputProxy& proxy): found(false), inner(proxy) {}
+        std::string name(){
+            return inner.name();
+        }
+        std::string description(){
+            return inner.description();
+        }
+        void initialize(DominationInstance& inst){
+            found = false;
+            inner.initialize(inst);
+        }
+        void process_set(DominationInstance& inst, VertexSet& dominating_set){
+            if (!found || dominating_set.get_size() < best_set.get_size())
+                best_set = dominating_set;
+            found = true;
+            inner.process_set(inst,dominating_set);
+        }
+        void process_batch(DominationInstance& inst, SolutionBatch& batch){
+            for(int i = 0; i < batch.size(); i++){
+                if (found && batch[i].get_size() >= best_set.get_size())
+                    continue;
+                best_set.reset_empty();
+                for(VertIndex v: batch[i])
+                    best_set.add(v);
+                found = true;
+            }
+            inner.process_batch(inst,batch);
+        }
+        void finalize(DominationInstance& inst){
+            inner.finalize(inst);
+        }
+        bool found;
+        VertexSet best_set;
+    private:
+        OutputProxy& inner;
+    };
+
+};
+
+#endif
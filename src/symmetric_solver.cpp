@@ -0,0 +1,243 @@
+/*  symmetric_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include "unidom_common.hpp"
+#include "graph_util.hpp"
+#include "compound_solver.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+
+namespace{
+
+    //Uses the automorphism group supplied with the instance (by the kneser and
+    //code_graph generators) to fix the first dominator up to symmetry. The vertices are
+    //split into the orbits of the group, and for each orbit O_i in turn, the base solver
+    //is run with a representative r_i of O_i forced in and every vertex of the earlier
+    //orbits forced out. Every set is the image of a set in one of these branches, so
+    //with an optimizing base solver the smallest set over all branches is minimum (and
+    //each branch after the first only looks for strictly smaller sets). On a vertex
+    //transitive graph, there is a single branch.
+    //
+    //With a base solver which generates all sets, the minimal dominating sets found in
+    //each branch are output (one or more per orbit of minimal sets), and the number of
+    //minimal dominating sets of each size in the whole graph is counted from them: a set
+    //D of branch i stands for |O_i|/|D n O_i| sets.
+    class SymmetricSolver: public CompoundSolverBase{
+    public:
+        SymmetricSolver(): CompoundSolverBase("DD") {}
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            all_optimal = false;
+            if (!usable_symmetry(inst)){
+                unidom::SolverPtr solver = spawn_base_solver(vector<string>());
+                solver->solve(inst,output_proxy);
+                all_optimal = solver->result_is_optimal();
+                return;
+            }
+            vector< vector<VertIndex> > orbits = permutation_orbits(inst.G, inst.automorphism_generators);
+            //Larger orbits first, so that the later branches exclude as many vertices as possible
+            std::stable_sort(orbits.begin(), orbits.end(), [](const vector<VertIndex>& a, const vector<VertIndex>& b){
+                return a.size() > b.size();
+            });
+            unidom::log << "Symmetry: " << inst.automorphism_generators.size() << " generators, " << orbits.size() << " vertex orbit" << ((orbits.size() == 1)? "":"s") << std::endl;
+            if (base_generates_all())
+                solve_all(inst, orbits, output_proxy);
+            else
+                solve_minimum(inst, orbits, output_proxy);
+        }
+
+        bool result_is_optimal(){
+            return all_optimal;
+        }
+        bool result_is_cacheable(){
+            return base_result_is_cacheable();
+        }
+    private:
+        bool all_optimal = false;
+
+        //The generators must be automorphisms which preserve force_out (and a nonempty
+        //force_in set already fixes the first dominator)
+        bool usable_symmetry(DominationInstance& inst){
+            if (inst.automorphism_generators.size() == 0){
+                unidom::log << "No automorphisms supplied with the instance; solving without symmetry" << std::endl;
+                return false;
+            }
+            if (inst.force_in.get_size() > 0){
+                unidom::log << "Vertices forced into the set; solving without symmetry" << std::endl;
+                return false;
+            }
+            for(auto& p: inst.automorphism_generators){
+                if (!is_automorphism(inst.G, p))
+                    throw unidom::ConfigurableError("The automorphism generators supplied with the instance are not automorphisms of the graph.");
+                for(VertIndex v: inst.force_out)
+                    if (!inst.force_out.contains(p[v])){
+                        unidom::log << "The force_out set is not preserved by the automorphisms; solving without symmetry" << std::endl;
+                        return false;
+                    }
+            }
+            return true;
+        }
+
+        //The instance for branch i: r_i forced in and the earlier orbits forced out
+        DominationInstance branch_instance(DominationInstance& inst, vector< vector<VertIndex> >& orbits, unsigned int i){
+            DominationInstance branch_inst = inst;
+            branch_inst.automorphism_generators.clear();
+            branch_inst.incumbent.reset_empty();
+            branch_inst.force_in.add(orbits[i][0]);
+            for(unsigned int j = 0; j < i; j++)
+                for(VertIndex v: orbits[j])
+                    branch_inst.force_out.add(v);
+            return branch_inst;
+        }
+
+        void solve_minimum(DominationInstance& inst, vector< vector<VertIndex> >& orbits, OutputProxy& output_proxy){
+            output_proxy.initialize(inst);
+            VertexSet best_set;
+            bool found = false;
+            if (inst.incumbent.get_size() > 0 && unidom::is_dominating_set(inst,inst.incumbent)){
+                best_set = inst.incumbent;
+                found = true;
+                unidom::log << "Starting from an incumbent of size " << best_set.get_size() << std::endl;
+                output_proxy.process_set(inst,best_set);
+            }
+            all_optimal = true;
+            for(unsigned int i = 0; i < orbits.size(); i++){
+                if (found && best_set.get_size() <= std::max(inst.lower_bound_hint, 1u))
+                    break;
+                if (inst.force_out.contains(orbits[i][0]))
+                    continue;
+                DominationInstance branch_inst = branch_instance(inst, orbits, i);
+                vector<string> bound_arguments;
+                if (found)
+                    bound_arguments = {"-u", std::to_string(best_set.get_size()-1)};
+                unidom::SolverPtr solver = spawn_base_solver(bound_arguments);
+                BestSetCaptureProxy capture;
+                solver->solve(branch_inst, capture);
+                all_optimal = all_optimal && solver->result_is_optimal();
+                unidom::log << "Orbit " << i << " (" << orbits[i].size() << " vertices, representative " << orbits[i][0] << "): ";
+                if (capture.found && (!found || capture.best_set.get_size() < best_set.get_size())){
+                    best_set = capture.best_set;
+                    found = true;
+                    output_proxy.process_set(inst,best_set);
+                    unidom::log << best_set.get_size() << std::endl;
+                }else{
+                    unidom::log << "no smaller set" << std::endl;
+                }
+            }
+            output_proxy.finalize(inst);
+        }
+
+        void solve_all(DominationInstance& inst, vector< vector<VertIndex> >& orbits, OutputProxy& output_proxy){
+            Graph& G = inst.G;
+            int n = G.n();
+            vector<int> orbit_of(n);
+            for(unsigned int i = 0; i < orbits.size(); i++)
+                for(VertIndex v: orbits[i])
+                    orbit_of[v] = i;
+
+            //Number of minimal sets of each size in the whole graph
+            std::map<unsigned int, unsigned long long> total_counts;
+
+            //Forwards the minimal sets of the branch (the base solver may also produce
+            //some non-minimal sets, depending on its search order)
+            class MinimalSetProxy: public OutputProxy{
+            public:
+                MinimalSetProxy(DominationInstance& inst, OutputProxy& inner, std::function< void(VertexSet&) > count_set):
+                    inst(inst), inner(inner), count_set(count_set), dominators(inst.G.n()) {}
+                string name(){
+                    return "minimal_set_filter";
+                }
+                string description(){
+                    return "";
+                }
+                void process_set(DominationInstance& branch_inst, VertexSet& dominating_set){
+                    Graph& G = inst.G;
+                    std::fill(dominators.begin(), dominators.end(), 0);
+                    for(VertIndex v: dominating_set){
+                        dominators[v]++;
+                        for(VertIndex u: G[v].neighbours())
+                            dominators[u]++;
+                    }
+                    for(VertIndex v: dominating_set){
+                        bool has_private_neighbour = dominators[v] == 1;
+                        for(VertIndex u: G[v].neighbours())
+                            has_private_neighbour = has_private_neighbour || dominators[u] == 1;
+                        if (!has_private_neighbour)
+                            return;
+                    }
+                    count_set(dominating_set);
+                    inner.process_set(inst,dominating_set);
+                }
+            private:
+                DominationInstance& inst;
+                OutputProxy& inner;
+                std::function< void(VertexSet&) > count_set;
+                vector<int> dominators;
+            };
+
+            output_proxy.initialize(inst);
+            all_optimal = false;
+            for(unsigned int i = 0; i < orbits.size(); i++){
+                if (inst.force_out.contains(orbits[i][0]))
+                    continue;
+                //Sets of the branch by size and number of vertices in O_i. The minimal sets
+                //of size s with k vertices in O_i (and none in earlier orbits) are mapped onto
+                //each other by the group, and each contains k images of r_i, so there are
+                //|O_i|/k times as many of them as there are in the branch.
+                std::map< std::pair<unsigned int, unsigned int>, unsigned long long > branch_counts;
+                auto count_set = [&](VertexSet& D){
+                    unsigned int in_orbit = 0;
+                    for(VertIndex v: D)
+                        if (orbit_of[v] == (int)i)
+                            in_orbit++;
+                    branch_counts[{D.get_size(), in_orbit}]++;
+                };
+                DominationInstance branch_inst = branch_instance(inst, orbits, i);
+                unidom::SolverPtr solver = spawn_base_solver(vector<string>());
+                MinimalSetProxy filter(inst, output_proxy, count_set);
+                solver->solve(branch_inst, filter);
+                for(auto& [key, count]: branch_counts)
+                    total_counts[key.first] += count*orbits[i].size()/key.second;
+            }
+            output_proxy.finalize(inst);
+
+            unsigned long long total = 0;
+            for(auto& [size, count]: total_counts){
+                unidom::log << "Minimal dominating sets of size " << size << ": " << count << std::endl;
+                total += count;
+            }
+            unidom::log << "Total minimal dominating sets (counted over orbits): " << total << std::endl;
+        }
+    };
+
+}
+
+REGISTER_SOLVER( SymmetricSolver, "symmetric", "Branch on one representative of each vertex orbit of the automorphisms supplied with the instance (by kneser and code_graph), solving each branch with a base solver (-base NAME args...); with a base solver generating all sets, count minimal sets over the orbits" );
@@ -0,0 +1,191 @@
+/*  tiny_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <array>
+#include <cstdint>
+#include "unidom_common.hpp"
+
+using std::string;
+using std::array;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+
+namespace{
+
+    //For graphs with at most 32 vertices (such as streams of small graphs from geng),
+    //where the setup of the backtracking solvers costs more than the search itself.
+    //Each closed neighbourhood is a 32-bit mask, and the subsets of the candidate
+    //vertices are enumerated in increasing order of size (and lexicographically within
+    //each size), with the union of the closed neighbourhoods of each subset built up one
+    //vertex at a time. A subset is abandoned when some undominated vertex has no candidate
+    //left to dominate it (later in the order), or when the undominated vertices outnumber
+    //what its remaining vertices could dominate (by the maximum closed degree).
+    //The optimizing version outputs the first (so minimum) dominating set found. The
+    //generating version outputs every dominating set with size between -l and -u
+    //(not just the minimal ones) and logs the number of sets of each size.
+    template<bool GENERATE_ALL>
+    class TinySolver: public Solver{
+    public:
+        static const int MAX_TINY_VERTS = 32;
+        typedef std::uint32_t VertexMask;
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-u" || arg == "-max")
+                upper_bound = parser.get_next_unsigned_int();
+            else if (arg == "-l" || arg == "-min")
+                lower_bound = parser.get_next_unsigned_int();
+            else
+                return false;
+            return true;
+        }
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            Graph& G = inst.G;
+            int n = G.n();
+            if (n > MAX_TINY_VERTS)
+                throw unidom::ConfigurableError("The "+name()+" solver only handles graphs with at most 32 vertices.");
+            dom_inst = &inst;
+            this->output_proxy = &output_proxy;
+
+            all_vertices = (n == MAX_TINY_VERTS)? ~VertexMask(0) : (VertexMask(1) << n) - 1;
+            max_cover = 0;
+            for(VertIndex v = 0; v < n; v++){
+                neighbourhoods[v] = VertexMask(1) << v;
+                for(VertIndex u: G[v].neighbours())
+                    neighbourhoods[v] |= VertexMask(1) << u;
+                max_cover = std::max(max_cover, __builtin_popcount(neighbourhoods[v]));
+            }
+            forced_set = 0;
+            VertexMask forced_dominated = 0;
+            for(VertIndex v: inst.force_in){
+                forced_set |= VertexMask(1) << v;
+                forced_dominated |= neighbourhoods[v];
+            }
+            num_candidates = 0;
+            for(VertIndex v = 0; v < n; v++)
+                if (!inst.force_in.contains(v) && !inst.force_out.contains(v))
+                    candidates[num_candidates++] = v;
+
+            //unreachable_from[i]: vertices with no candidate in their closed neighbourhood
+            //at position i or later
+            for(int i = 0; i <= num_candidates; i++){
+                VertexMask reachable = 0;
+                for(int j = i; j < num_candidates; j++)
+                    reachable |= neighbourhoods[candidates[j]];
+                unreachable_from[i] = all_vertices & ~reachable;
+            }
+
+            int num_forced = inst.force_in.get_size();
+            int first_size = std::max<int>(lower_bound, num_forced);
+            if (!GENERATE_ALL)
+                first_size = std::max<int>(first_size, inst.lower_bound_hint);
+            int last_size = std::min<int>(upper_bound, num_forced+num_candidates);
+
+            found = false;
+            nodes_visited = 0;
+            set_counts.fill(0);
+            output_proxy.initialize(inst);
+            for(int size = first_size; size <= last_size; size++){
+                enumerate(0, size-num_forced, forced_set, forced_dominated);
+                if (!GENERATE_ALL && found)
+                    break;
+            }
+            output_proxy.finalize(inst);
+            if (GENERATE_ALL){
+                unsigned long long total = 0;
+                for(int size = 0; size <= n; size++){
+                    if (set_counts[size] == 0)
+                        continue;
+                    unidom::log << "Dominating sets of size " << size << ": " << set_counts[size] << std::endl;
+                    total += set_counts[size];
+                }
+                unidom::log << "Total dominating sets: " << total << std::endl;
+            }
+        }
+
+        unsigned long long search_node_count(){
+            return nodes_visited;
+        }
+        bool generates_all(){
+            return GENERATE_ALL;
+        }
+        bool result_is_optimal(){
+            return !GENERATE_ALL && lower_bound == 0;
+        }
+        bool result_is_cacheable(){
+            return !GENERATE_ALL && lower_bound == 0 && upper_bound >= (unsigned int)MAX_TINY_VERTS;
+        }
+    private:
+        unsigned int upper_bound = MAX_TINY_VERTS;
+        unsigned int lower_bound = 0;
+
+        DominationInstance* dom_inst;
+        OutputProxy* output_proxy;
+
+        VertexMask all_vertices, forced_set;
+        array<VertexMask, MAX_TINY_VERTS> neighbourhoods;
+        array<VertIndex, MAX_TINY_VERTS> candidates;
+        array<VertexMask, MAX_TINY_VERTS+1> unreachable_from;
+        int num_candidates;
+        int max_cover;
+
+        bool found;
+        unsigned long long nodes_visited;
+        array<unsigned long long, MAX_TINY_VERTS+1> set_counts;
+        VertexSet output_set;
+
+        //Choose remaining more vertices from candidates[start...]
+        void enumerate(int start, int remaining, VertexMask chosen, VertexMask dominated){
+            nodes_visited++;
+            if (remaining == 0){
+                if (dominated == all_vertices)
+                    report_set(chosen);
+                return;
+            }
+            VertexMask undominated = all_vertices & ~dominated;
+            if ((undominated & unreachable_from[start]) || __builtin_popcount(undominated) > remaining*max_cover)
+                return;
+            for(int i = start; i <= num_candidates-remaining; i++){
+                VertIndex v = candidates[i];
+                enumerate(i+1, remaining-1, chosen | (VertexMask(1) << v), dominated | neighbourhoods[v]);
+                if (!GENERATE_ALL && found)
+                    return;
+            }
+        }
+
+        void report_set(VertexMask chosen){
+            output_set.reset_empty();
+            for(VertexMask bits = chosen; bits; bits &= bits-1)
+                output_set.add(__builtin_ctz(bits));
+            set_counts[output_set.get_size()]++;
+            found = true;
+            output_proxy->process_set(*dom_inst, output_set);
+        }
+    };
+
+    typedef TinySolver<false> TinySolverOptimize;
+    typedef TinySolver<true> TinySolverAll;
+}
+
+REGISTER_SOLVER( TinySolverOptimize, "tiny", "Subset enumeration in increasing size order over 32-bit neighbourhood masks, for graphs with at most 32 vertices (optimization)" );
+REGISTER_SOLVER( TinySolverAll, "tiny_all", "Subset enumeration in increasing size order over 32-bit neighbourhood masks, for graphs with at most 32 vertices (generates every dominating set with size between -l and -u)" );
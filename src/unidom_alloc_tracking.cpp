@@ -0,0 +1,145 @@
+/*  unidom_alloc_tracking.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include "unidom_common.hpp"
+#include "unidom_alloc_tracking.hpp"
+
+namespace{
+    std::atomic<unsigned long long> total_allocations(0);
+    thread_local unsigned long long thread_allocations = 0;
+    thread_local unsigned long long ignored_allocations = 0;
+    std::atomic<bool> nonzero_hot_path_allocations(false);
+}
+
+#ifdef UNIDOM_TRACK_ALLOCATIONS
+
+namespace{
+    void* counted_allocation(std::size_t size){
+        total_allocations.fetch_add(1,std::memory_order_relaxed);
+        thread_allocations++;
+        void* p = std::malloc(size? size : 1);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+    void* counted_aligned_allocation(std::size_t size, std::align_val_t alignment){
+        total_allocations.fetch_add(1,std::memory_order_relaxed);
+        thread_allocations++;
+        std::size_t a = (std::size_t)alignment;
+        void* p = std::aligned_alloc(a, ((size? size : 1) + a - 1)/a*a);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+void* operator new(std::size_t size){
+    return counted_allocation(size);
+}
+void* operator new[](std::size_t size){
+    return counted_allocation(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept{
+    try{
+        return counted_allocation(size);
+    }catch(std::bad_alloc&){
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept{
+    try{
+        return counted_allocation(size);
+    }catch(std::bad_alloc&){
+        return nullptr;
+    }
+}
+void* operator new(std::size_t size, std::align_val_t alignment){
+    return counted_aligned_allocation(size,alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment){
+    return counted_aligned_allocation(size,alignment);
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+void operator delete[](void* p) noexcept{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept{
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept{
+    std::free(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept{
+    std::free(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept{
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept{
+    std::free(p);
+}
+
+bool unidom::allocation_tracking_enabled(){
+    return true;
+}
+
+#else
+
+bool unidom::allocation_tracking_enabled(){
+    return false;
+}
+
+#endif
+
+unsigned long long unidom::allocation_count(){
+    return thread_allocations - ignored_allocations;
+}
+
+unsigned long long unidom::total_allocation_count(){
+    return total_allocations.load(std::memory_order_relaxed);
+}
+
+unidom::IgnoredAllocationScope::IgnoredAllocationScope(): start_count(allocation_count()) {}
+unidom::IgnoredAllocationScope::~IgnoredAllocationScope(){
+    ignored_allocations += allocation_count() - start_count;
+}
+
+void unidom::report_hot_path_allocations(std::string solver_name, unsigned long long count){
+    if (count > 0){
+        unidom::log << "ERROR: " << count << " heap allocation" << ((count == 1)? "":"s") << " during the search of solver " << solver_name << std::endl;
+        nonzero_hot_path_allocations.store(true);
+    }else{
+        unidom::log << "No heap allocations during the search of solver " << solver_name << std::endl;
+    }
+}
+
+bool unidom::hot_path_allocations_detected(){
+    return nonzero_hot_path_allocations.load();
+}
@@ -0,0 +1,63 @@
+/*  unidom_alloc_tracking.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef UNIDOM_ALLOC_TRACKING_H
+#define UNIDOM_ALLOC_TRACKING_H
+
+#include <string>
+
+//When compiled with UNIDOM_TRACK_ALLOCATIONS defined (e.g. with 'make alloc_check'),
+//the global operator new is replaced with a version that counts every call.
+//Otherwise, the functions below report zero allocations.
+
+namespace unidom{
+
+    bool allocation_tracking_enabled();
+    
+    //Number of calls to operator new made so far by the calling thread (so that the
+    //searches of one thread are not charged for the allocations of others), not
+    //counting those inside an IgnoredAllocationScope
+    unsigned long long allocation_count();
+    
+    //Total number of calls to operator new so far, over all threads
+    unsigned long long total_allocation_count();
+    
+    //Allocations made by the calling thread while this exists are left out of
+    //allocation_count, e.g. the residual solves of a bound audit in the middle of a
+    //search (a search run inside the scope still sees its own allocations).
+    class IgnoredAllocationScope{
+    public:
+        IgnoredAllocationScope();
+        ~IgnoredAllocationScope();
+        IgnoredAllocationScope(const IgnoredAllocationScope&) = delete;
+        IgnoredAllocationScope& operator=(const IgnoredAllocationScope&) = delete;
+    private:
+        unsigned long long start_count;
+    };
+    
+    //Log the number of allocations that occurred inside the search of the given solver
+    //(which should be zero), and remember if it was nonzero.
+    void report_hot_path_allocations(std::string solver_name, unsigned long long count);
+    
+    //True if any call to report_hot_path_allocations reported a nonzero count.
+    bool hot_path_allocations_detected();
+
+};
+
+#endif
@@ -97,6 +97,20 @@ namespace unidom{
         return proxy_iterable<typename T::reverse_iterator>( collection.rbegin(), collection.rend() );
     }
     
+    //Stable insertion sort of [begin,end) (in order of less(a,b)). Unlike std::stable_sort,
+    //it never allocates a buffer, so it can be used for the short arrays ranked in each
+    //search node.
+    template<typename T, typename Compare>
+    void insertion_sort(T* begin, T* end, Compare less){
+        for(T* i = begin+1; i < end; i++){
+            T x = *i;
+            T* j = i;
+            for(; j > begin && less(x, *(j-1)); j--)
+                *j = *(j-1);
+            *j = x;
+        }
+    }
+    
     
 };
 
@@ -23,6 +23,7 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <stdexcept>
 #include "unidom_common.hpp"
 
 using std::string;
@@ -181,6 +182,68 @@ void unidom::describe_components(){
 }
 
 
+bool unidom::is_dominating_set(DominationInstance& inst, VertexSet& S){
+    Graph& G = inst.G;
+    std::vector<char> dominated(G.n(),0);
+    for(VertIndex v: S){
+        if (v < 0 || v >= G.n() || inst.force_out.contains(v))
+            return false;
+        dominated[v] = 1;
+        for(VertIndex u: G[v].neighbours())
+            dominated[u] = 1;
+    }
+    for(VertIndex v: inst.force_in)
+        if (!S.contains(v))
+            return false;
+    return std::find(dominated.begin(), dominated.end(), 0) == dominated.end();
+}
+
+std::string unidom::ListArgumentTokenizer::get_next_string(){
+    if (current_idx >= args.size())
+        throw ConfigurableError("Too few arguments (expected string)");
+    return args[current_idx++];
+}
+int unidom::ListArgumentTokenizer::get_next_int(){
+    string arg = get_next_string();
+    try{
+        return std::stoi(arg);
+    }catch(std::invalid_argument e){
+        throw ConfigurableError("Expected an integer, not \""+arg+"\"");
+    }
+}
+unsigned int unidom::ListArgumentTokenizer::get_next_unsigned_int(){
+    string arg = get_next_string();
+    try{
+        return (unsigned int)std::stoul(arg);
+    }catch(std::invalid_argument e){
+        throw ConfigurableError("Expected a positive integer, not \""+arg+"\"");
+    }
+}
+double unidom::ListArgumentTokenizer::get_next_double(){
+    string arg = get_next_string();
+    try{
+        return std::stod(arg);
+    }catch(std::invalid_argument e){
+        throw ConfigurableError("Expected a float, not \""+arg+"\"");
+    }
+}
+
+
+void unidom::OutputProxy::process_batch(DominationInstance& inst, SolutionBatch& batch){
+    //The scratch set is left empty after each call, so it only needs a full reset
+    //if a previous call was interrupted by an exception.
+    if (batch_scratch_set.get_size() > 0)
+        batch_scratch_set.reset_empty();
+    for(int i = 0; i < batch.size(); i++){
+        for(VertIndex v: batch[i])
+            batch_scratch_set.add(v);
+        process_set(inst, batch_scratch_set);
+        for(VertIndex v: batch[i])
+            batch_scratch_set.remove(v);
+    }
+}
+
+
 namespace{
     std::mt19937 random_generator(1);
 }
@@ -192,4 +255,9 @@ void unidom::set_random_seed(unsigned int seed){
 unsigned int unidom::random_in_range(unsigned int lower, unsigned int upper){
     std::uniform_int_distribution<int> range(lower,upper);
     return range(random_generator);
+}
+
+double unidom::random_unit_interval(){
+    std::uniform_real_distribution<double> range(0.0,1.0);
+    return range(random_generator);
 }
\ No newline at end of file
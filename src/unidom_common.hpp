@@ -36,8 +36,23 @@ namespace unidom{
         Graph G;
         VertexSet force_in; //Set of vertices that must be in the set
         VertexSet force_out; //Set of vertices that must not be in the set
+        //Optional edge clique cover: every edge of G lies in at least one of
+        //these cliques (empty if no cover is known)
+        std::vector< std::vector<VertIndex> > clique_cover;
+        //Optional dominating set known in advance (empty if none), e.g. the repaired
+        //result of a previous instance when re-solving after small edits
+        VertexSet incumbent;
+        //A known lower bound on the size of a minimum dominating set (0 if none)
+        unsigned int lower_bound_hint = 0;
+        //Optional generators of a group of automorphisms of G (each a permutation
+        //mapping vertex v to p[v]), supplied by generators of very symmetric graphs
+        //(empty if none are known)
+        std::vector< std::vector<VertIndex> > automorphism_generators;
     };
     
+    //True if S dominates the graph and respects force_in and force_out
+    bool is_dominating_set(DominationInstance& inst, VertexSet& S);
+    
     
     
     
@@ -50,6 +65,23 @@ namespace unidom{
         virtual bool has_next() = 0;
     };
     
+    //Tokenizer over a fixed list of arguments (used to pass arguments to
+    //components created by other components).
+    class ListArgumentTokenizer: public ArgumentTokenizer{
+    public:
+        ListArgumentTokenizer(std::vector<std::string> arguments): args(arguments), current_idx(0) {}
+        std::string get_next_string();
+        int get_next_int();
+        unsigned int get_next_unsigned_int();
+        double get_next_double();
+        bool has_next(){
+            return current_idx < args.size();
+        }
+    private:
+        std::vector<std::string> args;
+        unsigned int current_idx;
+    };
+    
     class ConfigurableError{
     public:
         ConfigurableError(std::string s){
@@ -107,6 +139,59 @@ namespace unidom{
         virtual bool read_next(DominationInstance& inst) = 0;
     };
     
+    //A compact list of dominating sets (stored back to back as vertex indices)
+    //which lets a solver hand over many sets with a single call to the output proxy.
+    class SolutionBatch{
+    public:
+        class Entry{
+        public:
+            Entry(const VertIndex* start, const VertIndex* end): start_ptr(start), end_ptr(end){}
+            const VertIndex* begin() const{
+                return start_ptr;
+            }
+            const VertIndex* end() const{
+                return end_ptr;
+            }
+            int get_size() const{
+                return end_ptr - start_ptr;
+            }
+        private:
+            const VertIndex* start_ptr;
+            const VertIndex* end_ptr;
+        };
+        
+        SolutionBatch(){
+            clear();
+        }
+        //Reserve enough space that adding up to max_sets sets with a total of max_elements
+        //vertices will not reallocate.
+        void reserve(int max_sets, int max_elements){
+            offsets.reserve(max_sets+1);
+            elements.reserve(max_elements);
+        }
+        void clear(){
+            elements.clear();
+            offsets.clear();
+            offsets.push_back(0);
+        }
+        void add(const VertexSet& S){
+            elements.insert(elements.end(), S.begin(), S.end());
+            offsets.push_back(elements.size());
+        }
+        int size() const{
+            return offsets.size()-1;
+        }
+        bool empty() const{
+            return size() == 0;
+        }
+        Entry operator[](int i) const{
+            return Entry(elements.data()+offsets[i], elements.data()+offsets[i+1]);
+        }
+    private:
+        std::vector<VertIndex> elements;
+        std::vector<int> offsets; //Set i occupies elements[offsets[i]] to elements[offsets[i+1]-1]
+    };
+    
     class OutputProxy: public Configurable{
     public:
         //May be thrown during process_set. If thrown, then the solver should
@@ -114,7 +199,13 @@ namespace unidom{
         class TerminateOutput{ };
         virtual void initialize(DominationInstance& inst){ }
         virtual void process_set(DominationInstance& inst, VertexSet& dominating_set) = 0;
+        //Receives several sets at once (in the order they were generated). The default
+        //implementation just passes each set to process_set, so proxies only need to
+        //override this if they can do something cheaper with a whole batch.
+        virtual void process_batch(DominationInstance& inst, SolutionBatch& batch);
         virtual void finalize(DominationInstance& inst){ }
+    private:
+        VertexSet batch_scratch_set;
     };
     
     class PreprocessFilter: public Configurable{
@@ -125,6 +216,27 @@ namespace unidom{
     class Solver: public Configurable{
     public:
         virtual void solve(DominationInstance& inst, OutputProxy& output_proxy) = 0;
+        //True if solve generates every dominating set (with size in the configured
+        //range) instead of a sequence of improving sets
+        virtual bool generates_all(){
+            return false;
+        }
+        //Number of search nodes visited by the last call to solve (0 if not tracked)
+        virtual unsigned long long search_node_count(){
+            return 0;
+        }
+        //True if the last call to solve was an optimizing search which ran to
+        //completion (so the last set produced is a minimum dominating set).
+        //Only these results are stored in the result cache.
+        virtual bool result_is_optimal(){
+            return false;
+        }
+        //True if, with the current arguments, the correct output of solve is any
+        //minimum dominating set (an optimizing solver with no bounds on the set size),
+        //so that the result cache may be used in place of the search.
+        virtual bool result_is_cacheable(){
+            return false;
+        }
     };
     
     typedef std::shared_ptr<Solver> SolverPtr;
@@ -142,6 +254,22 @@ namespace unidom{
         
         Graph original_input_graph;
         
+        //Arguments given to each component on the command line (kept for logging)
+        std::vector<std::string> input_source_arguments;
+        std::vector< std::vector<std::string> > preprocess_filter_arguments;
+        std::vector<std::string> solver_arguments;
+        std::vector<std::string> output_proxy_arguments;
+        
+        std::string telemetry_file; //Empty if telemetry is disabled ("-" for the log stream)
+        std::string result_cache_directory; //Empty if the result cache is disabled
+        
+        //The best set found for the previous instance (in the vertex numbering of the
+        //input source) and a lower bound on the domination number of its graph, ignoring
+        //force_in and force_out (0 if unknown). Used by input sources which produce
+        //sequences of related instances.
+        std::vector<VertIndex> previous_result;
+        unsigned int previous_lower_bound = 0;
+        
         SolverContext(): input_source(nullptr), solver(nullptr), output_proxy(nullptr){}
     };
     
@@ -156,6 +284,7 @@ namespace unidom{
     
     void set_random_seed(unsigned int seed);
     unsigned int random_in_range(unsigned int lower, unsigned int upper); //Range is inclusive
+    double random_unit_interval(); //Uniform in [0,1)
     
     void describe_components();
     
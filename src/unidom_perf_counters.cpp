@@ -0,0 +1,145 @@
+/*  unidom_perf_counters.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include "unidom_common.hpp"
+#include "unidom_perf_counters.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace{
+    //Only the first failure to open any counters is logged
+    bool unavailable_reported = false;
+
+#ifdef __linux__
+    struct CounterConfig{
+        unsigned int type;
+        unsigned long long config;
+    };
+    const CounterConfig counter_configs[unidom::PerfCounters::NUM_COUNTERS] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+
+    int open_counter(const CounterConfig& counter){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = counter.type;
+        attr.config = counter.config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+#endif
+}
+
+namespace unidom{
+
+    PerfCounters::PerfCounters(): opened(false), any_available(false) {
+        fds.fill(-1);
+    }
+    PerfCounters::~PerfCounters(){
+#ifdef __linux__
+        for(int fd: fds)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    bool PerfCounters::open(){
+        if (opened)
+            return any_available;
+        opened = true;
+        std::string reason = "not supported on this platform";
+#ifdef __linux__
+        for(int i = 0; i < NUM_COUNTERS; i++){
+            fds[i] = open_counter(counter_configs[i]);
+            if (fds[i] >= 0)
+                any_available = true;
+            else
+                reason = std::string("perf_event_open: ") + strerror(errno);
+        }
+#endif
+        if (!any_available && !unavailable_reported){
+            unavailable_reported = true;
+            log << "Performance counters are unavailable (" << reason << ")" << std::endl;
+        }
+        return any_available;
+    }
+
+    void PerfCounters::start(){
+#ifdef __linux__
+        for(int fd: fds)
+            if (fd >= 0){
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+    }
+    void PerfCounters::stop(){
+#ifdef __linux__
+        for(int fd: fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    void PerfCounters::read(Values& values){
+        values.fill(-1);
+#ifdef __linux__
+        for(int i = 0; i < NUM_COUNTERS; i++){
+            if (fds[i] < 0)
+                continue;
+            unsigned long long buffer[3]; //Value, time enabled, time running
+            if (::read(fds[i], buffer, sizeof(buffer)) != sizeof(buffer))
+                continue;
+            if (buffer[2] == 0)
+                values[i] = 0;
+            else if (buffer[2] < buffer[1])
+                values[i] = (long long)((double)buffer[0]*buffer[1]/buffer[2]);
+            else
+                values[i] = buffer[0];
+        }
+#endif
+    }
+
+    bool PerfCounters::available(int counter){
+        return fds[counter] >= 0;
+    }
+
+    std::string PerfCounters::counter_name(int counter){
+        static const char* names[NUM_COUNTERS] = {"cycles", "instructions", "L1D read misses", "LLC misses", "branch misses"};
+        return names[counter];
+    }
+
+};
@@ -0,0 +1,63 @@
+/*  unidom_perf_counters.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef UNIDOM_PERF_COUNTERS_H
+#define UNIDOM_PERF_COUNTERS_H
+
+#include <array>
+#include <string>
+
+namespace unidom{
+
+    //Hardware performance counters of the calling thread (through perf_event_open on
+    //Linux), used by the backtracking solvers with -perf. Each counter is opened on its
+    //own, so counters which the CPU or the kernel settings (perf_event_paranoid) do not
+    //allow are just left out, and if none can be opened, the reason is logged once and
+    //the solver runs as usual.
+    class PerfCounters{
+    public:
+        static const int NUM_COUNTERS = 5;
+        enum Counter{ CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES };
+        typedef std::array<long long, NUM_COUNTERS> Values;
+
+        PerfCounters();
+        ~PerfCounters();
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        //Opens the counters (on the first call); false if none are available
+        bool open();
+        //Resets the counters to zero and starts counting
+        void start();
+        void stop();
+        //The counts so far (scaled up if the kernel multiplexed the counter), with -1
+        //for counters which are not available. Does not allocate.
+        void read(Values& values);
+
+        bool available(int counter);
+        static std::string counter_name(int counter);
+    private:
+        std::array<int, NUM_COUNTERS> fds;
+        bool opened;
+        bool any_available;
+    };
+
+};
+
+#endif
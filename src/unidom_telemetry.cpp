@@ -0,0 +1,164 @@
+/*  unidom_telemetry.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "unidom_common.hpp"
+#include "unidom_telemetry.hpp"
+#include "unidom_alloc_tracking.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::ResourceSnapshot;
+using unidom::PipelineTelemetry;
+
+namespace{
+    //Reads the current (VmRSS) and peak (VmHWM) resident set sizes from /proc/self/status
+    void read_rss_kb(long& rss_kb, long& peak_rss_kb){
+        rss_kb = peak_rss_kb = -1;
+        std::ifstream status("/proc/self/status");
+        string line;
+        while(std::getline(status,line)){
+            std::istringstream fields(line);
+            string key;
+            long value;
+            if (!(fields >> key >> value))
+                continue;
+            if (key == "VmRSS:")
+                rss_kb = value;
+            else if (key == "VmHWM:")
+                peak_rss_kb = value;
+        }
+    }
+
+    string json_string(const string& s){
+        static const char* hex_digits = "0123456789abcdef";
+        string result = "\"";
+        for(unsigned char c: s){
+            if (c == '"' || c == '\\'){
+                result += '\\';
+                result += c;
+            }else if (c < 0x20){
+                result += "\\u00";
+                result += hex_digits[c >> 4];
+                result += hex_digits[c & 0xf];
+            }else
+                result += c;
+        }
+        return result + "\"";
+    }
+    string json_string_list(const vector<string>& L){
+        string result = "[";
+        for(unsigned int i = 0; i < L.size(); i++)
+            result += (i > 0? ",":"") + json_string(L[i]);
+        return result + "]";
+    }
+}
+
+ResourceSnapshot ResourceSnapshot::now(){
+    ResourceSnapshot result;
+    result.wall_time = std::chrono::steady_clock::now();
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF,&usage) == 0)
+        result.cpu_seconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec/1000000.0
+                           + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec/1000000.0;
+    else
+        result.cpu_seconds = 0;
+    read_rss_kb(result.rss_kb, result.peak_rss_kb);
+    result.allocations = unidom::total_allocation_count();
+    return result;
+}
+
+bool ResourceSnapshot::reset_peak_rss(){
+    //Writing 5 to clear_refs sets the high-water mark to the current RSS (Linux 4.0 and later)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    return (clear_refs << "5" << std::flush) ? true : false;
+}
+
+void PipelineTelemetry::begin_instance(){
+    end_phase();
+    phases.clear();
+    instance_index++;
+}
+
+void PipelineTelemetry::start_phase(string name){
+    end_phase();
+    current_phase = name;
+    phase_open = true;
+    peak_rss_reset = ResourceSnapshot::reset_peak_rss();
+    phase_start = ResourceSnapshot::now();
+}
+
+void PipelineTelemetry::end_phase(){
+    if (!phase_open)
+        return;
+    phase_open = false;
+    ResourceSnapshot phase_end = ResourceSnapshot::now();
+    PhaseRecord record;
+    record.name = current_phase;
+    record.wall_seconds = std::chrono::duration_cast<std::chrono::microseconds>(phase_end.wall_time - phase_start.wall_time).count()/1000000.0;
+    record.cpu_seconds = phase_end.cpu_seconds - phase_start.cpu_seconds;
+    //Without the reset, VmHWM is the peak of the whole process so far
+    record.peak_rss_kb = peak_rss_reset? phase_end.peak_rss_kb : -1;
+    record.rss_kb = phase_end.rss_kb;
+    record.allocations = phase_end.allocations - phase_start.allocations;
+    phases.push_back(record);
+}
+
+void PipelineTelemetry::write_json(std::ostream& out, unidom::SolverContext& C){
+    end_phase();
+
+    Graph& G = C.original_input_graph;
+    long long total_degree = 0;
+    for(auto& v: G.V())
+        total_degree += v.deg();
+
+    std::ostringstream line;
+    line << "{\"instance\":" << instance_index;
+    line << ",\"vertices\":" << G.n() << ",\"edges\":" << total_degree/2;
+    line << ",\"input_source\":{\"name\":" << json_string(C.input_source->name()) << ",\"arguments\":" << json_string_list(C.input_source_arguments) << "}";
+    line << ",\"filters\":[";
+    for(unsigned int i = 0; i < C.preprocess_filters.size(); i++){
+        line << (i > 0? ",":"") << "{\"name\":" << json_string(C.preprocess_filters[i]->name());
+        vector<string> arguments;
+        if (i < C.preprocess_filter_arguments.size())
+            arguments = C.preprocess_filter_arguments[i];
+        line << ",\"arguments\":" << json_string_list(arguments) << "}";
+    }
+    line << "]";
+    line << ",\"solver\":{\"name\":" << json_string(C.solver->name()) << ",\"arguments\":" << json_string_list(C.solver_arguments) << "}";
+    line << ",\"output\":{\"name\":" << json_string(C.output_proxy->name()) << ",\"arguments\":" << json_string_list(C.output_proxy_arguments) << "}";
+    line << ",\"phases\":[";
+    for(unsigned int i = 0; i < phases.size(); i++){
+        PhaseRecord& P = phases[i];
+        line << (i > 0? ",":"") << "{\"name\":" << json_string(P.name);
+        line << ",\"wall_seconds\":" << P.wall_seconds << ",\"cpu_seconds\":" << P.cpu_seconds;
+        line << ",\"peak_rss_kb\":" << P.peak_rss_kb << ",\"rss_kb\":" << P.rss_kb;
+        if (unidom::allocation_tracking_enabled())
+            line << ",\"allocations\":" << P.allocations;
+        line << "}";
+    }
+    line << "]}";
+    out << line.str() << std::endl;
+}
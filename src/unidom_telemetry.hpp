@@ -0,0 +1,107 @@
+/*  unidom_telemetry.hpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef UNIDOM_TELEMETRY_H
+#define UNIDOM_TELEMETRY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "unidom_common.hpp"
+
+namespace unidom{
+
+    //Resource usage of the whole process at one point in time.
+    struct ResourceSnapshot{
+        std::chrono::steady_clock::time_point wall_time;
+        double cpu_seconds; //User + system time
+        long peak_rss_kb; //High-water mark of the resident set size since the last reset_peak_rss (-1 if unavailable)
+        long rss_kb; //Current resident set size (-1 if unavailable)
+        unsigned long long allocations; //Calls to operator new so far (only counted in allocation tracking builds)
+
+        static ResourceSnapshot now();
+        //Reset the high-water mark to the current resident set size (false if not supported)
+        static bool reset_peak_rss();
+    };
+
+    //Records the wall time, CPU time and memory usage of each phase of the
+    //pipeline (input, preprocessing, solving, output) for one instance at a time.
+    //Starting a phase ends the previous one.
+    class PipelineTelemetry{
+    public:
+        PipelineTelemetry(): instance_index(-1), phase_open(false), peak_rss_reset(false) {}
+
+        void begin_instance();
+        void start_phase(std::string name);
+        void end_phase();
+
+        //Write a single line of JSON describing the current instance.
+        void write_json(std::ostream& out, SolverContext& C);
+    private:
+        struct PhaseRecord{
+            std::string name;
+            double wall_seconds;
+            double cpu_seconds;
+            long peak_rss_kb;
+            long rss_kb;
+            unsigned long long allocations;
+        };
+        std::vector<PhaseRecord> phases;
+        int instance_index;
+
+        bool phase_open;
+        bool peak_rss_reset; //True if the high-water mark was reset when the current phase started
+        std::string current_phase;
+        ResourceSnapshot phase_start;
+    };
+
+    //Wraps an output proxy so that the time spent in finalize() is recorded
+    //as its own phase (instead of being charged to the solver).
+    class TelemetryOutputProxy: public OutputProxy{
+    public:
+        TelemetryOutputProxy(OutputProxy& proxy, PipelineTelemetry& telemetry): inner(proxy), telemetry(telemetry) {}
+        std::string name(){
+            return inner.name();
+        }
+        std::string description(){
+            return inner.description();
+        }
+        void initialize(DominationInstance& inst){
+            inner.initialize(inst);
+        }
+        void process_set(DominationInstance& inst, VertexSet& dominating_set){
+            inner.process_set(inst,dominating_set);
+        }
+        void process_batch(DominationInstance& inst, SolutionBatch& batch){
+            inner.process_batch(inst,batch);
+        }
+        void finalize(DominationInstance& inst){
+            telemetry.start_phase("output_finalize");
+            inner.finalize(inst);
+            telemetry.end_phase();
+        }
+    private:
+        OutputProxy& inner;
+        PipelineTelemetry& telemetry;
+    };
+
+};
+
+#endif
@@ -0,0 +1,370 @@
+/*  verify_solver.cpp
+
+    unidom: A modular domination solver
+    Copyright (C) 2016 - 2024 Bill Bird
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "unidom_common.hpp"
+
+using std::string;
+using std::vector;
+
+using unidom::Solver;
+using unidom::OutputProxy;
+using unidom::DominationInstance;
+
+namespace{
+
+    //Bytes of the certificate file handed to each thread at a time
+    const size_t CHUNK_BYTES = 16 << 20;
+
+    struct ChunkResult{
+        unsigned long long lines = 0; //Lines read (up to the terminator or failure, if any)
+        unsigned long long certificates = 0;
+        int min_size = unidom::MAX_VERTS+1, max_size = -1;
+        bool terminated = false; //True if the chunk contains a "-1" line
+        const char* terminator_end = nullptr; //Just past the first "-1" line
+        bool failed = false;
+        string reason;
+    };
+
+    //Checks the certificates written by output_all or output_best against the
+    //instance: each line holds the size of a set followed by its vertices (as real
+    //indices), and each instance's block ends with a line containing -1
+    //(-format best treats every line as a separate block instead).
+    //The closed neighbourhood of each vertex is a bitset, so checking a set of
+    //size k costs k*n/64 word operations. The file is mapped into memory and split
+    //into chunks (at line boundaries) which are checked by -threads T threads.
+    //The first invalid certificate is reported with its line number, and ends the
+    //program with an error.
+    class VerifySolver: public Solver{
+    public:
+        VerifySolver(): num_threads(std::max(1u, std::thread::hardware_concurrency())), one_line_per_instance(false),
+            data(nullptr), file_size(0), offset(0), line_number(0) {}
+        ~VerifySolver(){
+            if (data)
+                munmap((void*)data, file_size);
+        }
+
+        bool accept_argument(string arg, unidom::ArgumentTokenizer& parser){
+            if (arg == "-file")
+                filename = parser.get_next_string();
+            else if (arg == "-threads"){
+                num_threads = parser.get_next_unsigned_int();
+                if (num_threads == 0)
+                    throw unidom::ConfigurableError("Parameter -threads must be at least 1.");
+            }else if (arg == "-format"){
+                string format = parser.get_next_string();
+                if (format == "all")
+                    one_line_per_instance = false;
+                else if (format == "best")
+                    one_line_per_instance = true;
+                else
+                    throw unidom::ConfigurableError("Unknown certificate format \""+format+"\" (use all or best).");
+            }else
+                return Solver::accept_argument(arg,parser);
+            return true;
+        }
+
+        void solve(DominationInstance& inst, OutputProxy& output_proxy){
+            if (!data)
+                map_file();
+            build_bitsets(inst);
+
+            output_proxy.initialize(inst);
+            unsigned long long first_line = line_number+1;
+            unsigned long long certificates = 0;
+            int min_size = unidom::MAX_VERTS+1, max_size = -1;
+            bool block_ended = false;
+            while(offset < file_size && !block_ended){
+                vector<const char*> bounds = split_chunks();
+                vector<ChunkResult> results(bounds.size()-1);
+                vector<std::thread> workers;
+                for(unsigned int i = 0; i+1 < bounds.size(); i++)
+                    workers.emplace_back([&,i](){
+                        check_chunk(bounds[i], bounds[i+1], results[i]);
+                    });
+                for(auto& worker: workers)
+                    worker.join();
+
+                //Only chunks up to the first terminator belong to this instance
+                for(unsigned int i = 0; i < results.size(); i++){
+                    ChunkResult& R = results[i];
+                    if (R.failed){
+                        unidom::log << "Invalid certificate on line " << line_number+R.lines << " of " << filename << ": " << R.reason << std::endl;
+                        throw unidom::ConfigurableError("Certificate verification failed (line "+std::to_string(line_number+R.lines)+").");
+                    }
+                    line_number += R.lines;
+                    certificates += R.certificates;
+                    min_size = std::min(min_size, R.min_size);
+                    max_size = std::max(max_size, R.max_size);
+                    if (R.terminated){
+                        offset = R.terminator_end - data;
+                        block_ended = true;
+                        break;
+                    }
+                    offset = bounds[i+1] - data;
+                }
+            }
+            if (certificates == 0)
+                unidom::log << "No certificates found for this instance in " << filename << std::endl;
+            else
+                unidom::log << "Verified " << certificates << " certificates (lines " << first_line << "-" << line_number
+                            << ", sizes " << min_size << "-" << max_size << "): all valid" << std::endl;
+            output_proxy.finalize(inst);
+        }
+    private:
+        string filename;
+        unsigned int num_threads;
+        bool one_line_per_instance;
+
+        const char* data;
+        size_t file_size;
+        size_t offset; //Start of the unread part of the file
+        unsigned long long line_number; //Lines of the file read so far
+
+        int n, words;
+        vector<uint64_t> neighbourhoods; //n bitsets of `words` words
+        vector<uint64_t> full_set;
+        vector<VertIndex> vertex_of_real_index;
+        vector<int> real_index_of_vertex;
+        vector<char> forced_in, forced_out;
+        int force_in_count;
+
+        void map_file(){
+            if (filename == "")
+                throw unidom::ConfigurableError("The verify solver needs a certificate file (-file F).");
+            int fd = open(filename.c_str(), O_RDONLY);
+            struct stat st;
+            if (fd < 0 || fstat(fd, &st) != 0)
+                throw unidom::ConfigurableError("Unable to open certificate file \""+filename+"\".");
+            file_size = st.st_size;
+            if (file_size > 0){
+                void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED)
+                    throw unidom::ConfigurableError("Unable to map certificate file \""+filename+"\".");
+                madvise(mapping, file_size, MADV_SEQUENTIAL);
+                data = (const char*)mapping;
+            }
+            close(fd);
+        }
+
+        void build_bitsets(DominationInstance& inst){
+            Graph& G = inst.G;
+            n = G.n();
+            words = (n+63)/64;
+            neighbourhoods.assign((size_t)n*words, 0);
+            full_set.assign(words, 0);
+            int max_real_index = -1;
+            for(int v = 0; v < n; v++){
+                uint64_t* N = &neighbourhoods[(size_t)v*words];
+                N[v/64] |= 1ull << (v%64);
+                for(VertIndex u: G[v].neighbours())
+                    N[u/64] |= 1ull << (u%64);
+                full_set[v/64] |= 1ull << (v%64);
+                max_real_index = std::max(max_real_index, G[v].get_real_index());
+            }
+            vertex_of_real_index.assign(max_real_index+1, (VertIndex)Graph::INVALID_VERTEX);
+            real_index_of_vertex.resize(n);
+            for(int v = 0; v < n; v++){
+                vertex_of_real_index[G[v].get_real_index()] = v;
+                real_index_of_vertex[v] = G[v].get_real_index();
+            }
+            forced_in.assign(n,0);
+            forced_out.assign(n,0);
+            for(VertIndex v: inst.force_in)
+                forced_in[v] = 1;
+            for(VertIndex v: inst.force_out)
+                forced_out[v] = 1;
+            force_in_count = inst.force_in.get_size();
+        }
+
+        //Boundaries of up to num_threads chunks covering the next part of the file,
+        //each ending just after a newline (or at the end of the file).
+        vector<const char*> split_chunks(){
+            const char* end = data+file_size;
+            vector<const char*> bounds;
+            const char* position = data+offset;
+            bounds.push_back(position);
+            for(unsigned int i = 0; i < num_threads && position < end; i++){
+                const char* chunk_end = position + std::min(CHUNK_BYTES, (size_t)(end-position));
+                while(chunk_end < end && chunk_end[-1] != '\n')
+                    chunk_end++;
+                bounds.push_back(chunk_end);
+                position = chunk_end;
+            }
+            return bounds;
+        }
+
+        static bool read_int(const char*& p, const char* line_end, long long& value){
+            while(p < line_end && (*p == ' ' || *p == '\t' || *p == '\r'))
+                p++;
+            if (p == line_end)
+                return false;
+            bool negative = false;
+            if (*p == '-'){
+                negative = true;
+                p++;
+            }
+            if (p == line_end || *p < '0' || *p > '9')
+                return false;
+            value = 0;
+            while(p < line_end && *p >= '0' && *p <= '9'){
+                value = value*10 + (*p-'0');
+                if (value > (1ll << 40))
+                    return false;
+                p++;
+            }
+            if (negative)
+                value = -value;
+            return true;
+        }
+
+        void check_chunk(const char* begin, const char* end, ChunkResult& R){
+            vector<uint64_t> dominated(words);
+            vector<char> in_set(n,0);
+            vector<VertIndex> members;
+            const char* p = begin;
+            while(p < end){
+                const char* line_end = (const char*)memchr(p, '\n', end-p);
+                if (!line_end)
+                    line_end = end;
+                const char* next_line = (line_end < end)? line_end+1 : end;
+                R.lines++;
+                long long size;
+                const char* q = p;
+                if (!read_int(q, line_end, size)){
+                    //Blank lines are ignored
+                    bool blank = true;
+                    for(const char* c = p; c < line_end; c++)
+                        if (*c != ' ' && *c != '\t' && *c != '\r')
+                            blank = false;
+                    if (!blank){
+                        R.failed = true;
+                        R.reason = "malformed line";
+                        return;
+                    }
+                    p = next_line;
+                    continue;
+                }
+                if (size == -1){
+                    R.terminated = true;
+                    R.terminator_end = next_line;
+                    return;
+                }
+                if (!check_certificate(q, line_end, size, dominated, in_set, members, R.reason)){
+                    R.failed = true;
+                    return;
+                }
+                R.certificates++;
+                R.min_size = std::min(R.min_size, (int)size);
+                R.max_size = std::max(R.max_size, (int)size);
+                if (one_line_per_instance){
+                    R.terminated = true;
+                    R.terminator_end = next_line;
+                    return;
+                }
+                p = next_line;
+            }
+        }
+
+        bool check_certificate(const char* p, const char* line_end, long long size, vector<uint64_t>& dominated,
+                               vector<char>& in_set, vector<VertIndex>& members, string& reason){
+            members.clear();
+            long long real_index;
+            bool valid = true;
+            while(valid && read_int(p, line_end, real_index)){
+                if (real_index < 0 || real_index >= (long long)vertex_of_real_index.size() || vertex_of_real_index[real_index] == Graph::INVALID_VERTEX){
+                    reason = "vertex " + std::to_string(real_index) + " is not in the graph";
+                    valid = false;
+                    break;
+                }
+                VertIndex v = vertex_of_real_index[real_index];
+                if (in_set[v]){
+                    reason = "vertex " + std::to_string(real_index) + " is repeated";
+                    valid = false;
+                    break;
+                }
+                in_set[v] = 1;
+                members.push_back(v);
+            }
+            if (valid){
+                for(const char* c = p; c < line_end; c++)
+                    if (*c != ' ' && *c != '\t' && *c != '\r'){
+                        reason = "malformed line";
+                        valid = false;
+                        break;
+                    }
+            }
+            if (valid && size != (long long)members.size()){
+                reason = "size " + std::to_string(size) + " does not match the " + std::to_string(members.size()) + " vertices listed";
+                valid = false;
+            }
+            if (valid){
+                std::fill(dominated.begin(), dominated.end(), 0);
+                int force_in_found = 0;
+                for(VertIndex v: members){
+                    if (forced_out[v]){
+                        reason = "contains vertex " + std::to_string(real_index_of(v)) + " (in force_out)";
+                        valid = false;
+                        break;
+                    }
+                    force_in_found += forced_in[v];
+                    const uint64_t* N = &neighbourhoods[(size_t)v*words];
+                    for(int w = 0; w < words; w++)
+                        dominated[w] |= N[w];
+                }
+                if (valid && force_in_found < force_in_count){
+                    for(int v = 0; v < n; v++)
+                        if (forced_in[v] && !in_set[v]){
+                            reason = "missing vertex " + std::to_string(real_index_of(v)) + " (in force_in)";
+                            break;
+                        }
+                    valid = false;
+                }
+                for(int w = 0; valid && w < words; w++){
+                    uint64_t undominated = full_set[w] & ~dominated[w];
+                    if (undominated){
+                        int v = w*64 + __builtin_ctzll(undominated);
+                        reason = "vertex " + std::to_string(real_index_of(v)) + " is not dominated";
+                        valid = false;
+                    }
+                }
+            }
+            for(VertIndex v: members)
+                in_set[v] = 0;
+            return valid;
+        }
+
+        int real_index_of(VertIndex v){
+            return real_index_of_vertex[v];
+        }
+    };
+
+}
+
+REGISTER_SOLVER( VerifySolver, "verify", "Check the certificates in a file written by output_all (-file F, or -format best for output_best) against the instance, in -threads T threads" );
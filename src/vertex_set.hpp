@@ -26,8 +26,8 @@
 
 class VertexSet{
 public:
-    typedef VertIndex* iterator;
-    typedef const VertIndex* const_iterator;
+    typedef StoredVertIndex* iterator;
+    typedef const StoredVertIndex* const_iterator;
     
     VertexSet(){
         reset_empty();
@@ -94,8 +94,8 @@ public:
     }
 protected:
     int size;
-    std::array<VertIndex,unidom::MAX_VERTS> set_elements;
-    std::array<int,unidom::MAX_VERTS> set_indices;
+    std::array<StoredVertIndex,unidom::MAX_VERTS> set_elements;
+    std::array<StoredVertIndex,unidom::MAX_VERTS> set_indices;
     
 };
 